@@ -44,7 +44,15 @@ bool DrawingThread::threadInit()
 void DrawingThread::run()
 {
     lock_guard<mutex> lg(m_mutex);
+    if (m_isHeld)
+    {
+        return; // The previous frame stays on the display
+    }
+    publish();
+}
 
+void DrawingThread::publish()
+{
     yarp::sig::ImageOf<yarp::sig::PixelRgb> &img = m_imageOutPort.prepare();
     img.setExternal(m_image.data, FACE_WIDTH, FACE_HEIGHT);
     m_imageOutPort.writeStrict();
@@ -60,3 +68,16 @@ void DrawingThread::blackReset()
     lock_guard<mutex> lg(m_mutex);
     m_image.setTo((Scalar(0, 0, 0)));
 }
+
+void DrawingThread::holdFrames()
+{
+    lock_guard<mutex> lg(m_mutex);
+    m_isHeld = true;
+}
+
+void DrawingThread::releaseFrames()
+{
+    lock_guard<mutex> lg(m_mutex);
+    m_isHeld = false;
+    publish(); // The parts are already redrawn, so the new face does not wait for the next period
+}
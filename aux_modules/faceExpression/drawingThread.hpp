@@ -30,6 +30,9 @@ private:
     std::mutex&             m_mutex;
     cv::Mat& m_image;
     std::string m_moduleName;
+    bool m_isHeld = false;   // The frames are not published while it is set, protected by m_mutex
+
+    void publish();
 
 public:
     bool threadInit()  override;
@@ -38,6 +41,11 @@ public:
     void run() override;
 
     void blackReset();
+
+    // Stops publishing the frames, e.g. while the parts of a face state are changed
+    void holdFrames();
+    // Publishes the current frame right away and the next ones as usual. Call it once all the parts have been redrawn
+    void releaseFrames();
 };
 
 #endif
@@ -125,6 +125,7 @@ bool EarsThread::updateBars(float percentage)
 {
     lock_guard<mutex> faceguard(m_drawing_mutex);
 
+    m_percentage = percentage;
     earBar0_len = earBar0_minLen + (earBar0_maxLen - earBar0_minLen) *  percentage;
     earBar1_len = earBar1_minLen + (earBar1_maxLen - earBar1_minLen) *  percentage;
 
@@ -192,3 +193,14 @@ void EarsThread::enableDrawing(bool val)
         clearWithBlack();
     }
 }
+
+void EarsThread::redraw()
+{
+    lock_guard<recursive_mutex> lg(m_methods_mutex);
+    if (m_drawEnable == false)
+    {
+        clearWithBlack();
+        return;
+    }
+    updateBars(m_percentage);
+}
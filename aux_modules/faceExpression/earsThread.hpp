@@ -61,6 +61,7 @@ private:
     // Actual size of bars, changing
     int earBar0_len = 14;
     int earBar1_len = 16;
+    float m_percentage = 0.5; // Of the bars last drawn
 
     bool updateBars(float percentage);
     void clearWithBlack();
@@ -76,6 +77,7 @@ public:
 
     void setColor(float vr, float vg, float vb);
     void enableDrawing(bool activate);
+    void redraw(); // Draws the current state now, without waiting for the next period
 };
 
 #endif
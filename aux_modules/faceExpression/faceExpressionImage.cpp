@@ -12,6 +12,7 @@
 
 
 #define BLINK_STEP_NUM  10
+#define PART_PERIOD     0.020
 
 using namespace cv;
 using namespace std;
@@ -38,9 +39,9 @@ bool FaceExpressionImageModule::configure(ResourceFinder &rf)
     }
 
     m_thread_output = new DrawingThread(rf, getName(), 0.033, m_image, m_mutex);
-    m_thread_eyes   = new EyesThread(rf, getName(), 0.020, m_image, m_mutex);
-    m_thread_ears   = new EarsThread(rf, getName(), 0.020, m_image, m_mutex);
-    m_thread_mouth  = new MouthThread(rf, getName(), 0.020, m_image, m_mutex);
+    m_thread_eyes   = new EyesThread(rf, getName(), PART_PERIOD, m_image, m_mutex);
+    m_thread_ears   = new EarsThread(rf, getName(), PART_PERIOD, m_image, m_mutex);
+    m_thread_mouth  = new MouthThread(rf, getName(), PART_PERIOD, m_image, m_mutex);
 
     if (m_thread_output)
         if (!m_thread_output->start())
@@ -78,6 +79,7 @@ bool FaceExpressionImageModule::respondString(const Bottle& command, Bottle& rep
         reply.addString("color_ears  255 255 255");
         reply.addString("reset_to_default");
         reply.addString("emotion 0/1/2");
+        reply.addString("face_state 0/1/2 (255 255 255) (255 255 255) 0/1 0/1");
         reply.addString("black_screen");
         return true;
     }
@@ -142,6 +144,21 @@ bool FaceExpressionImageModule::respondString(const Bottle& command, Bottle& rep
         reply.addVocab32(yarp::os::Vocab32::encode("ok"));
         return true;
     }
+    else if (cmd == "face_state")
+    {
+        // emotion, ears color, mouth color, blink and talk, applied in a single frame
+        Bottle* ears = command.get(2).asList();
+        Bottle* mouth = command.get(3).asList();
+        if (command.size() < 6 || !ears || ears->size() < 3 || !mouth || mouth->size() < 3)
+        {
+            yError() << "Malformed face state " << command.toString();
+            reply.addVocab32(yarp::os::Vocab32::encode("fail"));
+            return true;
+        }
+        set_face_state(command.get(1).asInt32(), *ears, *mouth, command.get(4).asBool(), command.get(5).asBool());
+        reply.addVocab32(yarp::os::Vocab32::encode("ok"));
+        return true;
+    }
     else if (cmd == "reset_to_default")
     {
         reset_default();
@@ -214,6 +231,35 @@ bool FaceExpressionImageModule::start_listening(bool val)
     return true;
 }
 
+bool FaceExpressionImageModule::set_face_state(int emotion, const Bottle& ears, const Bottle& mouth, bool blink, bool talk)
+{
+    if (m_thread_output) m_thread_output->holdFrames();
+    if (!m_hasFaceState || blink != m_isBlinking)
+    {
+        start_blinking(blink);
+    }
+    if (!m_hasFaceState || talk != m_isTalking)
+    {
+        start_talking(talk); // Before the color, since stopping the talk resets the mouth
+    }
+    m_hasFaceState = true;
+    m_isBlinking = blink;
+    m_isTalking = talk;
+    if (m_thread_mouth)
+    {
+        m_thread_mouth->setExpression(emotion);
+        m_thread_mouth->setColor(mouth.get(0).asFloat32(), mouth.get(1).asFloat32(), mouth.get(2).asFloat32());
+    }
+    if (m_thread_ears) m_thread_ears->setColor(ears.get(0).asFloat32(), ears.get(1).asFloat32(), ears.get(2).asFloat32());
+
+    // Redrawn here instead of waiting for their threads, so that the released frame already has the whole new face.
+    // After the eyes, whose reset covers the whole image
+    if (m_thread_mouth) m_thread_mouth->redraw();
+    if (m_thread_ears) m_thread_ears->redraw();
+    if (m_thread_output) m_thread_output->releaseFrames();
+    return true;
+}
+
 bool FaceExpressionImageModule::reset_default()
 {
     if (m_thread_eyes)  m_thread_eyes->enableDrawing(true);
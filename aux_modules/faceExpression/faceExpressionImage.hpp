@@ -36,6 +36,11 @@ private:
     yarp::os::Port                                             m_rpcPort;
     cv::Mat                                                    m_image;
 
+    // Last face state applied, so that the blink and talk animations are only restarted when they change
+    bool                                                       m_hasFaceState = false;
+    bool                                                       m_isBlinking = false;
+    bool                                                       m_isTalking = false;
+
 public:
     FaceExpressionImageModule();
     bool configure(yarp::os::ResourceFinder &rf) override;
@@ -55,6 +60,7 @@ private:
     bool start_listening(bool val);
     bool reset_default();
     bool black();
+    bool set_face_state(int emotion, const yarp::os::Bottle& ears, const yarp::os::Bottle& mouth, bool blink, bool talk);
 
 };
 
@@ -181,3 +181,16 @@ void MouthThread::setExpression(int e)
 
     emotion = e;
 }
+
+void MouthThread::redraw()
+{
+    lock_guard<recursive_mutex> lg(m_methods_mutex);
+    if (m_audioIsPlaying)
+    {
+        updateTalk();
+    }
+    else
+    {
+        showExpression();
+    }
+}
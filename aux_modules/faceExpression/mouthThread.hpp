@@ -61,6 +61,7 @@ public:
     void enableDrawing(bool activate);
     void setColor(float vr, float vg, float vb);
     void setExpression(int e);
+    void redraw(); // Draws the current state now, without waiting for the next period
 
 };
 
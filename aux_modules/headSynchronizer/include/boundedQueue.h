@@ -0,0 +1,136 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_BOUNDED_QUEUE_H
+#define BEHAVIOR_TOUR_ROBOT_BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * Bounded lock-free queue for any number of producers and consumers.
+ *
+ * Every slot of the ring carries a sequence number telling whether it is free for the producer of a given
+ * position or full for its consumer, so that a push or a pop is a single compare-and-swap on the position
+ * plus the move of the element, and never waits for another thread.
+ */
+template <typename T>
+class BoundedQueue
+{
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<std::size_t> m_pushPosition{0};
+    alignas(64) std::atomic<std::size_t> m_popPosition{0};
+
+public:
+    /**
+     * @param capacity the maximum number of elements, rounded up to a power of two
+     */
+    explicit BoundedQueue(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots = std::make_unique<Slot[]>(size);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /**
+     * @return false if the queue is full
+     */
+    bool TryPush(T value)
+    {
+        return TryPush(std::move(value), [](T &, std::size_t) {});
+    }
+
+    /**
+     * @param onClaimed called with the element and its position once the position is taken and before the element can be
+     * popped, e.g. to number the elements in the order they are popped
+     * @return false if the queue is full
+     */
+    template <typename OnClaimed>
+    bool TryPush(T value, OnClaimed &&onClaimed)
+    {
+        std::size_t position = m_pushPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = m_slots[position & m_mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    onClaimed(value, position);
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The slot still holds the element of the previous round
+            }
+            else
+            {
+                position = m_pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @return the number of elements pushed since the queue was created, including the ones being pushed
+     */
+    [[nodiscard]] std::size_t GetPushCount() const
+    {
+        return m_pushPosition.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return false if the queue is empty
+     */
+    bool TryPop(T &outValue)
+    {
+        std::size_t position = m_popPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = m_slots[position & m_mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    outValue = std::move(slot.value);
+                    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The slot has not been filled yet
+            }
+            else
+            {
+                position = m_popPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_BOUNDED_QUEUE_H
@@ -8,14 +8,29 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/RFModule.h>
 #include <headSynchronizerRPC.h>
+#include <googleSynthesis_IDL.h>
+#include <speechClipStore.h>
+#include <boundedQueue.h>
+#include <array>
 #include <iostream>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <functional>
 #include <yarp/os/LogComponent.h>
 #include <yarp/dev/AudioRecorderStatus.h>
 #include <yarp/dev/AudioPlayerStatus.h>
 
 class StatusCallback;
+class SynthesisSoundCallback;
+class SynthesisStateCallback;
+class LanguageCallback;
+class PlayerStatusCallback;
+class MicrophoneStatusCallback;
 class HeadSynchronizer : public yarp::os::RFModule, public headSynchronizerRPC
 {
 private:
@@ -23,9 +38,89 @@ private:
     std::string m_name;
     std::mutex m_mutex;
     double m_period;
-    bool m_isSpeaking;
+    std::atomic<bool> m_isSpeaking;
     bool m_isError;
-    std::vector<std::string> m_textBuffer;
+
+    struct Utterance
+    {
+        std::uint64_t id{0}; // Position in the queue plus one, so that the ids follow the order the utterances are popped
+        std::string text;
+    };
+
+    BoundedQueue<Utterance> m_utterances;    // Texts said and not spoken yet, pushed by the RPC and popped by updateModule
+    std::atomic<int> m_pendingUtterances{0}; // Utterances said and not spoken or dropped yet
+    std::size_t m_minSentenceLength{40};     // Texts are split into sentences of at least this many characters
+
+    // Ids of the utterances, so that the clients can follow them without polling isSpeaking. The mutex is only used to wait
+    // for them, the ids are taken from the queue without locking
+    std::mutex m_utteranceMutex;
+    std::condition_variable m_utteranceDone;
+    std::uint64_t m_doneUtteranceId{0};               // Latest utterance spoken or dropped. They are popped in order, so all the previous ones are done too
+    std::atomic<std::uint64_t> m_resetUtteranceId{0}; // Latest utterance queued before the last reset, it and all the previous ones are dropped
+    std::mutex m_eventMutex;                           // The events are published by the RPC thread and by updateModule
+
+    struct PendingClip
+    {
+        std::uint64_t id; // Number of the request, so that the requester can wait for its own audio
+        SpeechClipStore::ClipKey key;
+        bool isPlayed; // False for the texts synthesized in advance and for the ones cleared by a reset
+        double requestTime;
+    };
+
+    SynthesisSoundCallback *m_soundCallback{nullptr};
+    SynthesisStateCallback *m_synthesisStateCallback{nullptr};
+    LanguageCallback *m_languageCallback{nullptr};
+    SpeechClipStore m_clipStore;
+    std::mutex m_voiceMutex;
+    SpeechClipStore::Voice m_voice;         // Voice read from googleSynthesis, kept if it stops answering
+    std::atomic<bool> m_isVoiceStale{true}; // Set by the language changes, so that the voice is read again only after them
+    std::mutex m_clipMutex;
+    std::condition_variable m_clipChanged;
+    std::deque<PendingClip> m_pendingClips;  // Texts sent to googleSynthesis whose audio has not been received yet. At most one
+    std::deque<std::string> m_preparedTexts; // Texts to synthesize in advance, only while no utterance is pending
+    std::uint64_t m_nextRequestId{1};
+    bool m_isSynthesisInSync{true};          // False after a request timed out, until googleSynthesis is idle again
+    double m_synthesisTimeout{10.0};         // Time after which the audio of a text is not expected anymore
+    bool m_isStopping{false};
+    std::thread m_prepareThread;
+    std::string m_synthesisSoundPort; // The audio of googleSynthesis, relayed to the player while the store is open
+    std::string m_playerAudioPort;
+    bool m_isSoundRelayed{false};
+
+    // Latest status of the audio player and of the microphone, written by the callbacks of their ports
+    PlayerStatusCallback *m_playerStatusCallback{nullptr};
+    MicrophoneStatusCallback *m_microphoneStatusCallback{nullptr};
+    std::atomic<bool> m_isAudioPlaying{false};
+    std::atomic<double> m_playerStatusTime{-1.0}; // System time of the latest player status, -1 if never received
+    std::atomic<std::size_t> m_playerBufferSize{0};
+    std::atomic<std::uint64_t> m_audioArrivals{0};     // Times the buffer of the player grew, i.e. new audio reached it
+    std::atomic<std::uint64_t> m_flushSequence{0};     // Number of the last flush of the player, one for every reset
+    std::atomic<std::uint64_t> m_acknowledgedFlush{0}; // Number of the last flush acknowledged by the player
+    std::uint64_t m_statusFlush{0};                    // Last acknowledged flush seen by the player status callback, only used by it
+    double m_flushTimeout{1.0};                        // Time waited for the player to acknowledge a flush
+    std::atomic<bool> m_isMicrophoneEnabled{false};
+    std::atomic<double> m_microphoneStatusTime{-1.0}; // System time of the latest microphone status, -1 if never received
+    std::atomic<bool> m_isPlayerStale{false};     // Only used to log when the player status becomes stale or fresh again
+    std::atomic<bool> m_isMicrophoneStale{false}; // Only used to log when the microphone status becomes stale or fresh again
+    double m_statusTimeout{1.0};                  // Time without a status after which the status is stale
+    std::mutex m_playerMutex;
+    std::condition_variable m_playerChanged; // Only used to wait for the changes of the player status
+
+    // Expression, ears and mouth of the face, sent to faceExpression as a single message applied in one frame
+    struct FaceState
+    {
+        int emotion{1};
+        std::array<int, 3> ears{0, 0, 255};
+        std::array<int, 3> mouth{0, 128, 0};
+        bool isBlinking{true};
+        bool isTalking{false};
+
+        bool operator==(const FaceState &other) const;
+    };
+
+    std::mutex m_faceMutex;
+    FaceState m_face;        // Last face state sent
+    bool m_isFaceSent{false}; // False until a state is sent, and after a reset, so that a restarted faceExpression gets it again
 
     std::string m_statusInputName;
     std::string m_synthesisOutputName;
@@ -37,10 +132,21 @@ private:
     std::string m_playerStatusName;
     std::string m_playerOutputName;
     std::string m_headSynchronizerThriftPortName;
+    std::string m_speechStatusOutputName;
+    std::string m_speechEventsOutputName;
+    std::string m_synthesisRPCName;
+    std::string m_synthesisSoundName;
+    std::string m_synthesisStateName;
+    std::string m_languageInputName;
+    std::string m_soundOutputName;
 
     yarp::os::BufferedPort<yarp::os::Bottle> m_pStatusInput;
     yarp::os::BufferedPort<yarp::dev::AudioRecorderStatus> m_pMicrophoneStatus;
     yarp::os::BufferedPort<yarp::dev::AudioPlayerStatus> m_pPlayerStatus;
+    yarp::os::BufferedPort<yarp::sig::Sound> m_pSynthesisSound;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pSynthesisState;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pLanguageInput;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pSpeechEvents;
 
     yarp::os::Port m_headSynchronizerThriftPort;
     yarp::os::Port m_pSynthesisOutput;
@@ -48,11 +154,33 @@ private:
     yarp::os::Port m_pMicrophoneOutput;
     yarp::os::Port m_pPlayerOutput;
     yarp::os::Port m_pFaceOutput;
+    yarp::os::Port m_pSpeechStatusOutput;
+    yarp::os::Port m_pSynthesisRPC;
+    yarp::os::Port m_pSoundOutput;
+    googleSynthesis_IDL m_synthesis;
     yarp::os::RpcServer m_pRPC;
 
     bool writeToPort(const std::string &s, yarp::os::Port &port);
     bool writeToPort(const std::string &s, yarp::os::Port &port, yarp::os::Bottle &res);
     bool isAudioPlaying();
+    bool waitAudioPlaying(bool isPlaying, double timeout);
+    bool waitPlayer(const std::function<bool()> &isDone, double timeout);
+    bool isStale(const std::atomic<double> &statusTime, std::atomic<bool> &isStale, const char *device);
+    void setSpeaking(bool isSpeaking);
+    void updateSpeaking();
+    void publishSpeechEvent(const std::string &event, std::uint64_t id);
+    void finishUtterance(std::uint64_t id);
+    void releaseUtterance();
+    bool speakUtterance(const Utterance &utterance);
+    bool updateFace(const std::function<void(FaceState &)> &change);
+    void setHappyFace(bool isHearing);
+    bool flushPlayer(std::uint64_t flush);
+    bool openClipStore(yarp::os::ResourceFinder &rf, const std::string &path);
+    SpeechClipStore::Voice getVoice();
+    bool speak(const std::string &text);
+    std::uint64_t requestSynthesis(const std::string &text, const SpeechClipStore::ClipKey &key, bool isPlayed);
+    void dropPendingClips(const std::string &reason);
+    void prepareSpeechRun();
 
 public:
     HeadSynchronizer(const std::string &name);
@@ -76,11 +204,20 @@ public:
     virtual bool busyFaceError();
     virtual bool happyFace();
     virtual bool busyFace();
+    virtual bool prepareSpeech(const std::vector<std::string> &texts);
+    virtual bool isStatusStale();
+    virtual std::int64_t sayUtterance(const std::string &text);
+    virtual bool waitForUtterance(const std::int64_t id, const double timeout);
 
     bool changeEmotion(int i);
     bool colorEars(int r, int g, int b);
     bool colorMouth(int r, int g, int b);
     bool getIsError();
+    void onSynthesisSound(yarp::sig::Sound &sound);
+    void onSynthesisState(const std::string &state);
+    void onLanguageChanged(const yarp::os::Bottle &language);
+    void onPlayerStatus(const yarp::dev::AudioPlayerStatus &status);
+    void onMicrophoneStatus(const yarp::dev::AudioRecorderStatus &status);
 };
 
 class StatusCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
@@ -94,4 +231,74 @@ private:
     HeadSynchronizer *m_headSynchronizer;
 };
 
+/**
+ * Receives the audio synthesized by googleSynthesis when the speech clip store is used
+ */
+class SynthesisSoundCallback : public yarp::os::TypedReaderCallback<yarp::sig::Sound>
+{
+public:
+    SynthesisSoundCallback(HeadSynchronizer *headSynchronizer);
+    using yarp::os::TypedReaderCallback<yarp::sig::Sound>::onRead;
+    void onRead(yarp::sig::Sound &sound) override;
+
+private:
+    HeadSynchronizer *m_headSynchronizer;
+};
+
+/**
+ * Receives the state of googleSynthesis when the speech clip store is used, so that a text without audio is detected
+ */
+class SynthesisStateCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+public:
+    SynthesisStateCallback(HeadSynchronizer *headSynchronizer);
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle &state) override;
+
+private:
+    HeadSynchronizer *m_headSynchronizer;
+};
+
+/**
+ * Receives the language changes notified by the TourManager, so that the voice is not read for every text
+ */
+class LanguageCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+public:
+    LanguageCallback(HeadSynchronizer *headSynchronizer);
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle &language) override;
+
+private:
+    HeadSynchronizer *m_headSynchronizer;
+};
+
+/**
+ * Receives the status of the audio player, so that it is never read on demand
+ */
+class PlayerStatusCallback : public yarp::os::TypedReaderCallback<yarp::dev::AudioPlayerStatus>
+{
+public:
+    PlayerStatusCallback(HeadSynchronizer *headSynchronizer);
+    using yarp::os::TypedReaderCallback<yarp::dev::AudioPlayerStatus>::onRead;
+    void onRead(yarp::dev::AudioPlayerStatus &status) override;
+
+private:
+    HeadSynchronizer *m_headSynchronizer;
+};
+
+/**
+ * Receives the status of the microphone, so that it is never read on demand
+ */
+class MicrophoneStatusCallback : public yarp::os::TypedReaderCallback<yarp::dev::AudioRecorderStatus>
+{
+public:
+    MicrophoneStatusCallback(HeadSynchronizer *headSynchronizer);
+    using yarp::os::TypedReaderCallback<yarp::dev::AudioRecorderStatus>::onRead;
+    void onRead(yarp::dev::AudioRecorderStatus &status) override;
+
+private:
+    HeadSynchronizer *m_headSynchronizer;
+};
+
 #endif // BEHAVIOR_TOUR_ROBOT_HEAD_SYNCHRONIZER_H
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_SENTENCE_CHUNKER_H
+#define BEHAVIOR_TOUR_ROBOT_SENTENCE_CHUNKER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Splits a text into sentences, so that they are synthesized and played one after the other.
+ *
+ * A sentence ends at '.', '!', '?' or ';' followed by a space. The sentences shorter than minLength
+ * characters are joined to the next one, so that abbreviations and short interjections do not become
+ * clips of their own. The same text is always split in the same way, so the chunks can be stored.
+ *
+ * @param text the text to split
+ * @param minLength the minimum length of a sentence. 0 splits at every sentence end
+ * @return the sentences, with the surrounding spaces removed. A text without sentence ends is returned whole
+ */
+std::vector<std::string> SplitSentences(const std::string &text, std::size_t minLength);
+
+#endif // BEHAVIOR_TOUR_ROBOT_SENTENCE_CHUNKER_H
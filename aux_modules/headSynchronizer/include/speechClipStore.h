@@ -0,0 +1,121 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_SPEECH_CLIP_STORE_H
+#define BEHAVIOR_TOUR_ROBOT_SPEECH_CLIP_STORE_H
+
+#include <yarp/sig/Sound.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Persistent store of the synthesized speech, so that the same text in the same voice is synthesized only once.
+ *
+ * The store is a directory with two files: the index, a hash table from the key of a clip to its position
+ * that is memory mapped, and the clips, where the samples are appended. Looking up a clip never reads the
+ * clips file, and reading a clip is a single read at the position given by the index.
+ */
+class SpeechClipStore
+{
+public:
+    /**
+     * The synthesis parameters that change the audio of a text
+     */
+    struct Voice
+    {
+        std::string language;
+        std::string voice;
+        double pitch{0.0};
+        double speed{1.0};
+    };
+
+    /**
+     * The key of a clip. The hash locates it in the index, the identity is stored with the clip and compared
+     * on every lookup, so that two texts with the same hash are never confused
+     */
+    struct ClipKey
+    {
+        std::uint64_t hash{0};
+        std::string identity; // The voice and the text, as they were hashed
+    };
+
+    SpeechClipStore() = default;
+    ~SpeechClipStore();
+
+    SpeechClipStore(const SpeechClipStore &) = delete;
+    SpeechClipStore &operator=(const SpeechClipStore &) = delete;
+
+    /**
+     * Opens the store, creating it if it does not exist. If the index is not a valid store, e.g. it was written
+     * by an older version or it is corrupted, the store is created again empty
+     * @param directory the directory of the store. Must exist
+     * @param capacity the maximum number of clips, only used when the store is created
+     * @return false if the files cannot be opened or created
+     */
+    bool Open(const std::string &directory, std::uint32_t capacity);
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * @return the key of a text synthesized with the given voice
+     */
+    [[nodiscard]] static ClipKey Key(const Voice &voice, const std::string &text);
+
+    [[nodiscard]] bool Contains(const ClipKey &key);
+
+    /**
+     * Reads a clip
+     * @param key the key of the clip
+     * @param outSound the audio of the clip
+     * @return false if the clip is not in the store or it cannot be read
+     */
+    bool Find(const ClipKey &key, yarp::sig::Sound &outSound);
+
+    /**
+     * Adds a clip. Nothing is done if the clip is already in the store
+     * @param key the key of the clip
+     * @param sound the audio of the clip
+     * @return false if the store is full, another clip has the same hash or the clip cannot be written
+     */
+    bool Add(const ClipKey &key, const yarp::sig::Sound &sound);
+
+private:
+    struct IndexHeader
+    {
+        char magic[8];
+        std::uint32_t capacity; // Always a power of two
+        std::uint32_t count;
+    };
+
+    struct IndexEntry
+    {
+        std::uint64_t key; // The hash of the clip, 0 if the entry is empty
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct ClipHeader
+    {
+        std::uint32_t frequency;
+        std::uint32_t channels;
+        std::uint64_t samples;
+        std::uint64_t identitySize; // Followed by the identity of the key and then by the samples
+    };
+
+    std::mutex m_mutex;
+    int m_indexFile{-1};
+    int m_clipsFile{-1};
+    void *m_index{nullptr};
+    std::size_t m_indexSize{0};
+    IndexHeader *m_header{nullptr};
+    IndexEntry *m_entries{nullptr};
+
+    // All of them must be called with the mutex locked
+    IndexEntry *FindEntry(std::uint64_t hash); // The entry of the hash, or the empty one where it would be added
+    bool ReadClip(const IndexEntry &entry, const ClipKey &key, std::size_t size, std::vector<char> &outData);
+    bool MapIndex(std::size_t size);
+    [[nodiscard]] bool IsIndexValid() const;
+    bool CreateIndex(std::uint32_t capacity);
+    void Release();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_SPEECH_CLIP_STORE_H
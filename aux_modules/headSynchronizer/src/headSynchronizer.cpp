@@ -1,4 +1,8 @@
 #include <headSynchronizer.h>
+#include <sentenceChunker.h>
+#include <yarp/os/SystemClock.h>
+#include <algorithm>
+#include <chrono>
 
 YARP_LOG_COMPONENT(HEAD_SYNCHRONIZER, "behavior_tour_robot.aux_modules.head_synchronizer", yarp::os::Log::TraceType)
 
@@ -6,6 +10,7 @@ HeadSynchronizer::HeadSynchronizer(const std::string &name) : m_name(name),
                                                               m_period(0.2),
                                                               m_isSpeaking(false),
                                                               m_isError(false),
+                                                              m_utterances(64),
                                                               m_synthesisOutputName("/" + name + "/result:o"),
                                                               m_eyeContactName("/" + name + "/eyeContact/rpc"),
                                                               m_statusInputName("/" + name + "/googleStatus:i"),
@@ -14,7 +19,14 @@ HeadSynchronizer::HeadSynchronizer(const std::string &name) : m_name(name),
                                                               m_playerStatusName("/" + name + "/playerStatus:i"),
                                                               m_playerOutputName("/" + name + "/player:o"),
                                                               m_faceOutputName("/" + name + "/face:o"),
-                                                              m_headSynchronizerThriftPortName("/" + name + "/thrift:s")
+                                                              m_headSynchronizerThriftPortName("/" + name + "/thrift:s"),
+                                                              m_speechStatusOutputName("/" + name + "/speechStatus:o"),
+                                                              m_speechEventsOutputName("/" + name + "/speechEvents:o"),
+                                                              m_synthesisRPCName("/" + name + "/synthesis/rpc"),
+                                                              m_synthesisSoundName("/" + name + "/synthesisSound:i"),
+                                                              m_synthesisStateName("/" + name + "/synthesisState:i"),
+                                                              m_languageInputName("/" + name + "/language:i"),
+                                                              m_soundOutputName("/" + name + "/sound:o")
 
 {
 }
@@ -36,11 +48,17 @@ bool HeadSynchronizer::configure(yarp::os::ResourceFinder &rf)
         return false;
     }
 
+    // The status of the devices is cached as it arrives, so that the queries never wait for the next one
+    m_statusTimeout = rf.check("statusTimeout") ? rf.find("statusTimeout").asFloat64() : 1.0;
+    m_microphoneStatusCallback = new MicrophoneStatusCallback(this);
+    m_playerStatusCallback = new PlayerStatusCallback(this);
+
     if (!m_pMicrophoneStatus.open(m_microphoneStatusName))
     {
         yCError(HEAD_SYNCHRONIZER, "Cannot open microphoneStatus port");
         return false;
     }
+    m_pMicrophoneStatus.useCallback(*m_microphoneStatusCallback);
 
     if (!m_pMicrophoneOutput.open(m_microphoneOutputName))
     {
@@ -53,12 +71,15 @@ bool HeadSynchronizer::configure(yarp::os::ResourceFinder &rf)
         yCError(HEAD_SYNCHRONIZER, "Cannot open playerStatus port");
         return false;
     }
+    m_pPlayerStatus.useCallback(*m_playerStatusCallback);
 
     if (!m_pPlayerOutput.open(m_playerOutputName))
     {
         yCError(HEAD_SYNCHRONIZER, "Cannot open playerOutput port");
         return false;
     }
+    m_flushTimeout = rf.check("flushTimeout") ? rf.find("flushTimeout").asFloat64() : 1.0;
+    m_pPlayerOutput.setTimeout(static_cast<float>(m_flushTimeout)); // So that a player not answering cannot block a reset
 
     if (!m_pFaceOutput.open(m_faceOutputName))
     {
@@ -66,6 +87,18 @@ bool HeadSynchronizer::configure(yarp::os::ResourceFinder &rf)
         return false;
     }
 
+    if (!m_pSpeechStatusOutput.open(m_speechStatusOutputName))
+    {
+        yCError(HEAD_SYNCHRONIZER, "Cannot open speechStatusOutput port");
+        return false;
+    }
+
+    if (!m_pSpeechEvents.open(m_speechEventsOutputName))
+    {
+        yCError(HEAD_SYNCHRONIZER, "Cannot open speechEventsOutput port");
+        return false;
+    }
+
     // --------- Thrift interface server side config --------- //
     if (!m_headSynchronizerThriftPort.open(m_headSynchronizerThriftPortName))
     {
@@ -79,21 +112,108 @@ bool HeadSynchronizer::configure(yarp::os::ResourceFinder &rf)
         return false;
     }
 
+    // Long texts are synthesized one sentence at a time, so that the speech starts after the first sentence instead of after the whole text
+    m_minSentenceLength = rf.check("minSentenceLength") ? static_cast<std::size_t>(rf.find("minSentenceLength").asInt32()) : 40;
+
+    // --------- Speech clip store --------- //
+    std::string clipStorePath = rf.check("clipStore") ? rf.find("clipStore").asString() : "";
+    if (!clipStorePath.empty() && !openClipStore(rf, clipStorePath))
+    {
+        yCWarning(HEAD_SYNCHRONIZER) << "Cannot use the speech clip store. All the texts will be synthesized by googleSynthesis.";
+    }
+
     yCInfo(HEAD_SYNCHRONIZER) << "Configuration done!";
     return true;
 }
 
+bool HeadSynchronizer::openClipStore(yarp::os::ResourceFinder &rf, const std::string &path)
+{
+    std::uint32_t capacity = rf.check("clipStoreCapacity") ? static_cast<std::uint32_t>(rf.find("clipStoreCapacity").asInt32()) : 4096;
+    m_synthesisSoundPort = rf.check("synthesisSoundPort") ? rf.find("synthesisSoundPort").asString() : "/googleSynthesis/sound:o";
+    m_playerAudioPort = rf.check("playerAudioPort") ? rf.find("playerAudioPort").asString() : "/audioPlayerWrapper/audio:i";
+    std::string synthesisStatePort = rf.check("synthesisStatePort") ? rf.find("synthesisStatePort").asString() : "/googleSynthesis/state:o";
+    std::string languagePort = rf.check("languagePort") ? rf.find("languagePort").asString() : "/TourManager/language:o";
+    if (!m_clipStore.Open(path, capacity))
+    {
+        return false;
+    }
+
+    if (!m_pSynthesisRPC.open(m_synthesisRPCName) || !m_pSoundOutput.open(m_soundOutputName) || !m_pSynthesisSound.open(m_synthesisSoundName) ||
+        !m_pSynthesisState.open(m_synthesisStateName) || !m_pLanguageInput.open(m_languageInputName))
+    {
+        yCError(HEAD_SYNCHRONIZER) << "Cannot open the ports of the speech clip store";
+        m_clipStore.Close();
+        return false;
+    }
+    m_synthesis.yarp().attachAsClient(m_pSynthesisRPC);
+    yarp::os::Network::connect(m_synthesisRPCName, "/googleSynthesis/rpc");
+
+    // The audio of googleSynthesis is relayed to the player, so that the texts synthesized in advance are not played
+    m_soundCallback = new SynthesisSoundCallback(this);
+    m_pSynthesisSound.useCallback(*m_soundCallback);
+    yarp::os::Network::disconnect(m_synthesisSoundPort, m_playerAudioPort);
+    yarp::os::Network::connect(m_synthesisSoundPort, m_synthesisSoundName);
+    yarp::os::Network::connect(m_soundOutputName, m_playerAudioPort);
+    m_isSoundRelayed = true;
+
+    // The failures of googleSynthesis tell which texts have no audio, and the language changes when the voice must be read again
+    m_synthesisStateCallback = new SynthesisStateCallback(this);
+    m_pSynthesisState.useCallback(*m_synthesisStateCallback);
+    if (!yarp::os::Network::connect(synthesisStatePort, m_synthesisStateName))
+    {
+        yCWarning(HEAD_SYNCHRONIZER) << "Cannot connect to" << synthesisStatePort << ". The texts without audio are only detected after" << m_synthesisTimeout << "seconds.";
+    }
+    m_languageCallback = new LanguageCallback(this);
+    m_pLanguageInput.useCallback(*m_languageCallback);
+    if (!yarp::os::Network::connect(languagePort, m_languageInputName))
+    {
+        yCDebug(HEAD_SYNCHRONIZER) << "Cannot connect to" << languagePort << "yet. The voice is read again on every prepareSpeech.";
+    }
+
+    m_isStopping = false;
+    m_prepareThread = std::thread([this]
+                                  { prepareSpeechRun(); });
+    return true;
+}
+
 bool HeadSynchronizer::close()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_clipMutex);
+        m_isStopping = true;
+    }
+    m_clipChanged.notify_all();
+    if (m_prepareThread.joinable())
+    {
+        m_prepareThread.join();
+    }
+    m_pSynthesisSound.close();
+    delete m_soundCallback;
+    m_pSoundOutput.close();
+    if (m_isSoundRelayed)
+    { // googleSynthesis plays directly again, as before the store was opened
+        yarp::os::Network::connect(m_synthesisSoundPort, m_playerAudioPort);
+        m_isSoundRelayed = false;
+    }
+    m_pSynthesisState.close();
+    delete m_synthesisStateCallback;
+    m_pLanguageInput.close();
+    delete m_languageCallback;
+    m_pSynthesisRPC.close();
+    m_clipStore.Close();
     delete m_statusCallback;
     m_pEyeContact.close();
     m_pStatusInput.close();
     m_pSynthesisOutput.close();
     m_pMicrophoneStatus.close();
+    delete m_microphoneStatusCallback;
     m_pMicrophoneOutput.close();
     m_pPlayerStatus.close();
+    delete m_playerStatusCallback;
     m_pPlayerOutput.close();
     m_pFaceOutput.close();
+    m_pSpeechStatusOutput.close();
+    m_pSpeechEvents.close();
     m_headSynchronizerThriftPort.close();
     return true;
 }
@@ -112,48 +232,107 @@ bool HeadSynchronizer::updateModule()
 {
     if (!isAudioPlaying())
     {
-        std::unique_lock<std::mutex> lck(m_mutex);
-        if (!m_textBuffer.empty())
+        Utterance utterance;
+        while (m_utterances.TryPop(utterance))
         {
-            std::string str = m_textBuffer.at(0);
-            lck.unlock();
-            if (isHearing())
-            {
-                stopHearing();
-            }
-            bool res = writeToPort(str, m_pSynthesisOutput);
-            if (!res)
+            bool res = true;
+            if (utterance.id > m_resetUtteranceId.load())
             {
-                yCError(HEAD_SYNCHRONIZER) << "I failed to sent the text to SynthesisOutput.";
-                return false;
+                res = speakUtterance(utterance);
             }
-            yCDebug(HEAD_SYNCHRONIZER) << "I sent successfully to googleSynthesis:" << str;
-            while (!isAudioPlaying())
+            else
             {
-                yarp::os::Time::delay(0.1);
+                yCDebug(HEAD_SYNCHRONIZER) << "I dropped the text said before the reset:" << utterance.text;
             }
-            yCDebug(HEAD_SYNCHRONIZER) << "I started speaking:" << str;
-            while (isAudioPlaying())
-            {
-                yarp::os::Time::delay(0.1);
-            }
-            yCDebug(HEAD_SYNCHRONIZER) << "I finished speaking:" << str;
-            lck.lock();
-            if (!m_textBuffer.empty()) // Needed check, as the buffer can be emptied async
+            finishUtterance(utterance.id);
+            releaseUtterance();
+            updateSpeaking(); // Notify the end of the speech now instead of at the next update
+            if (!res)
             {
-                m_textBuffer.erase(m_textBuffer.begin());
-                yCDebug(HEAD_SYNCHRONIZER) << "I removed from the buffer the text:" << str;
+                return false;
             }
-            lck.unlock();
         }
-        else
+        updateSpeaking();
+    }
+    return true;
+}
+
+bool HeadSynchronizer::speakUtterance(const Utterance &utterance)
+{
+    std::vector<std::string> sentences = SplitSentences(utterance.text, m_minSentenceLength);
+    if (isHearing())
+    {
+        stopHearing();
+    }
+
+    // Every sentence is sent as soon as the audio of the previous one reaches the player, so that it is synthesized while the previous one plays
+    std::uint64_t arrivals = m_audioArrivals.load();
+    for (std::size_t i = 0; i < sentences.size(); i++)
+    {
+        if (!speak(sentences[i]))
+        {
+            yCError(HEAD_SYNCHRONIZER) << "I failed to sent the text to SynthesisOutput.";
+            return false;
+        }
+        yCDebug(HEAD_SYNCHRONIZER) << "I sent successfully to googleSynthesis:" << sentences[i];
+        if (i == 0)
+        {
+            publishSpeechEvent("synthesis", utterance.id);
+        }
+        std::uint64_t target = arrivals + i + 1;
+        bool isArrived = waitPlayer([this, &utterance, target]
+                                    { return m_audioArrivals.load() >= target || utterance.id <= m_resetUtteranceId.load(); },
+                                    m_synthesisTimeout);
+        if (utterance.id <= m_resetUtteranceId.load())
+        {
+            yCDebug(HEAD_SYNCHRONIZER) << "The text was interrupted by a reset:" << utterance.text;
+            return true;
+        }
+        if (!isArrived)
         {
-            m_isSpeaking = false;
+            yCWarning(HEAD_SYNCHRONIZER) << "The audio of the text never started playing:" << sentences[i];
+            publishSpeechEvent("finished", utterance.id);
+            return true;
+        }
+        if (i == 0)
+        {
+            publishSpeechEvent("started", utterance.id);
+            yCDebug(HEAD_SYNCHRONIZER) << "I started speaking:" << utterance.text;
         }
     }
+    waitAudioPlaying(false, -1.0);
+    publishSpeechEvent("finished", utterance.id);
+    yCDebug(HEAD_SYNCHRONIZER) << "I finished speaking:" << utterance.text;
     return true;
 }
 
+void HeadSynchronizer::finishUtterance(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_utteranceMutex);
+    m_doneUtteranceId = id;
+    m_utteranceDone.notify_all();
+}
+
+void HeadSynchronizer::releaseUtterance()
+{
+    if (--m_pendingUtterances == 0)
+    { // The preparation of the speech in advance waits for the utterances, so that it never delays them
+        std::lock_guard<std::mutex> lock(m_clipMutex);
+        m_clipChanged.notify_all();
+    }
+}
+
+void HeadSynchronizer::publishSpeechEvent(const std::string &event, std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    yarp::os::Bottle &bot = m_pSpeechEvents.prepare();
+    bot.clear();
+    bot.addString(event);
+    bot.addInt64(static_cast<std::int64_t>(id));
+    bot.addFloat64(yarp::os::Time::now());
+    m_pSpeechEvents.writeStrict(); // Every event is delivered, a waiter could miss the end of its utterance otherwise
+}
+
 bool HeadSynchronizer::getIsError()
 {
     return m_isError;
@@ -161,13 +340,284 @@ bool HeadSynchronizer::getIsError()
 
 bool HeadSynchronizer::isAudioPlaying()
 {
-    yarp::dev::AudioPlayerStatus *playerStatus = m_pPlayerStatus.read();
-    if (playerStatus)
+    isStale(m_playerStatusTime, m_isPlayerStale, "audio player");
+    return m_isAudioPlaying.load(std::memory_order_acquire);
+}
+
+bool HeadSynchronizer::waitAudioPlaying(bool isPlaying, double timeout)
+{
+    return waitPlayer([this, isPlaying]
+                      { return m_isAudioPlaying.load(std::memory_order_acquire) == isPlaying; },
+                      timeout);
+}
+
+bool HeadSynchronizer::waitPlayer(const std::function<bool()> &isDone, double timeout)
+{
+    double startTime = yarp::os::SystemClock::nowSystem();
+    std::unique_lock<std::mutex> lock(m_playerMutex);
+    while (!isDone())
     {
-        return playerStatus->current_buffer_size > 0;
+        // Without a fresh status the player cannot be trusted, so the wait ends instead of hanging
+        if (isStale(m_playerStatusTime, m_isPlayerStale, "audio player") ||
+            (timeout >= 0.0 && yarp::os::SystemClock::nowSystem() - startTime > timeout))
+        {
+            return false;
+        }
+        m_playerChanged.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    return true;
+}
+
+bool HeadSynchronizer::isStale(const std::atomic<double> &statusTime, std::atomic<bool> &isStale, const char *device)
+{
+    double time = statusTime.load(std::memory_order_acquire);
+    bool isStaleNow = time < 0.0 || yarp::os::SystemClock::nowSystem() - time > m_statusTimeout;
+    if (isStale.exchange(isStaleNow) != isStaleNow)
+    {
+        if (isStaleNow)
+        {
+            yCWarning(HEAD_SYNCHRONIZER) << "No status of the" << device << "received for" << m_statusTimeout << "seconds. Its status is stale.";
+        }
+        else
+        {
+            yCInfo(HEAD_SYNCHRONIZER) << "The status of the" << device << "is received again.";
+        }
+    }
+    return isStaleNow;
+}
+
+bool HeadSynchronizer::isStatusStale()
+{
+    bool isPlayerStale = isStale(m_playerStatusTime, m_isPlayerStale, "audio player");
+    bool isMicrophoneStale = isStale(m_microphoneStatusTime, m_isMicrophoneStale, "microphone");
+    return isPlayerStale || isMicrophoneStale;
+}
+
+void HeadSynchronizer::onPlayerStatus(const yarp::dev::AudioPlayerStatus &status)
+{
+    bool isPlaying = status.current_buffer_size > 0;
+    bool isChanged = m_isAudioPlaying.exchange(isPlaying, std::memory_order_acq_rel) != isPlaying;
+    std::size_t bufferSize = status.current_buffer_size;
+    std::size_t previousSize = m_playerBufferSize.exchange(bufferSize);
+    // The first status after a flush could have been sent before it, so it only gives the size the next ones are compared with
+    std::uint64_t acknowledgedFlush = m_acknowledgedFlush.load();
+    bool isAfterFlush = m_statusFlush != acknowledgedFlush;
+    m_statusFlush = acknowledgedFlush;
+    bool isArrived = !isAfterFlush && bufferSize > previousSize; // The buffer only grows when new audio is added
+    if (isArrived)
+    {
+        m_audioArrivals++;
+    }
+    m_playerStatusTime.store(yarp::os::SystemClock::nowSystem(), std::memory_order_release);
+    if (isChanged || isArrived)
+    {
+        std::lock_guard<std::mutex> lock(m_playerMutex); // So that a waiter cannot miss the notification between its check and its wait
+        m_playerChanged.notify_all();
+    }
+}
+
+void HeadSynchronizer::onMicrophoneStatus(const yarp::dev::AudioRecorderStatus &status)
+{
+    m_isMicrophoneEnabled.store(status.enabled, std::memory_order_release);
+    m_microphoneStatusTime.store(yarp::os::SystemClock::nowSystem(), std::memory_order_release);
+}
+
+void HeadSynchronizer::updateSpeaking()
+{
+    std::lock_guard<std::mutex> lock(m_mutex); // So that two threads cannot publish the states in the opposite order
+    setSpeaking(m_pendingUtterances.load() > 0);
+}
+
+void HeadSynchronizer::setSpeaking(bool isSpeaking) // Called with m_mutex locked, so that the state always matches the queue
+{
+    if (m_isSpeaking == isSpeaking)
+    {
+        return;
+    }
+    m_isSpeaking = isSpeaking;
+
+    // Listeners wait on this event instead of polling isSpeaking()
+    yarp::os::Bottle status;
+    status.addString(isSpeaking ? "speaking" : "idle");
+    m_pSpeechStatusOutput.write(status);
+}
+
+SpeechClipStore::Voice HeadSynchronizer::getVoice()
+{
+    std::lock_guard<std::mutex> lock(m_voiceMutex);
+    if (!m_isVoiceStale.exchange(false))
+    {
+        return m_voice; // No language change since the last read, so no round trip to googleSynthesis
+    }
+    SpeechClipStore::Voice voice;
+    voice.language = m_synthesis.getLanguageCode();
+    if (voice.language.empty())
+    {
+        m_isVoiceStale = true; // Read again next time, googleSynthesis is not answering
+        return m_voice;
+    }
+    voice.voice = m_synthesis.getVoiceCode();
+    voice.pitch = m_synthesis.getPitch();
+    voice.speed = m_synthesis.getSpeed();
+    m_voice = voice;
+    yCDebug(HEAD_SYNCHRONIZER) << "The voice of googleSynthesis is" << m_voice.language << m_voice.voice;
+    return m_voice;
+}
+
+void HeadSynchronizer::onLanguageChanged(const yarp::os::Bottle &language)
+{
+    m_isVoiceStale = true;
+    yCDebug(HEAD_SYNCHRONIZER) << "The language of googleSynthesis changed to" << language.toString();
+}
+
+bool HeadSynchronizer::speak(const std::string &text)
+{
+    if (!m_clipStore.IsOpen())
+    {
+        return writeToPort(text, m_pSynthesisOutput);
+    }
+
+    SpeechClipStore::ClipKey key = SpeechClipStore::Key(getVoice(), text);
+    yarp::sig::Sound sound;
+    if (m_clipStore.Find(key, sound))
+    { // No round trip to the cloud, and it works even without network
+        yCDebug(HEAD_SYNCHRONIZER) << "I found in the speech clip store:" << text;
+        return m_pSoundOutput.write(sound);
+    }
+    return requestSynthesis(text, key, true) != 0;
+}
+
+std::uint64_t HeadSynchronizer::requestSynthesis(const std::string &text, const SpeechClipStore::ClipKey &key, bool isPlayed)
+{
+    // The audio carries nothing that tells which text it is, so a text is sent only when the previous one has its audio or has
+    // none: every audio then belongs to the only pending request, and a text without audio cannot shift the next ones
+    std::unique_lock<std::mutex> lock(m_clipMutex);
+    if (!m_clipChanged.wait_for(lock, std::chrono::duration<double>(m_synthesisTimeout), [this]
+                                { return m_isStopping || m_pendingClips.empty(); }))
+    {
+        dropPendingClips("its audio did not arrive in time");
+    }
+    if (!isPlayed && m_pendingUtterances.load() > 0)
+    { // An utterance has been said meanwhile, the text is prepared after it
+        m_preparedTexts.push_front(text);
+        return 0;
+    }
+    if (m_isStopping || !writeToPort(text, m_pSynthesisOutput))
+    {
+        return 0;
+    }
+    std::uint64_t id = m_nextRequestId++;
+    m_pendingClips.push_back({id, key, isPlayed, yarp::os::Time::now()});
+    return id;
+}
+
+void HeadSynchronizer::dropPendingClips(const std::string &reason) // Called with m_clipMutex locked
+{
+    if (m_pendingClips.empty())
+    {
+        return;
+    }
+    for (const PendingClip &clip : m_pendingClips)
+    {
+        yCWarning(HEAD_SYNCHRONIZER) << "The text" << clip.id << "has no audio," << reason;
+    }
+    m_pendingClips.clear();
+    m_isSynthesisInSync = false; // Its audio could still arrive, and it would be taken for the audio of the next text
+    m_clipChanged.notify_all();
+}
+
+void HeadSynchronizer::onSynthesisSound(yarp::sig::Sound &sound)
+{
+    SpeechClipStore::ClipKey key;
+    bool isPlayed = true; // The audio not requested by the headSynchronizer is played as before
+    bool isStored = false;
+    {
+        std::lock_guard<std::mutex> lock(m_clipMutex);
+        if (!m_pendingClips.empty() && yarp::os::Time::now() - m_pendingClips.front().requestTime > m_synthesisTimeout)
+        {
+            dropPendingClips("its audio arrived too late");
+        }
+        if (!m_pendingClips.empty())
+        {
+            key = std::move(m_pendingClips.front().key);
+            isPlayed = m_pendingClips.front().isPlayed;
+            isStored = m_isSynthesisInSync;
+            m_pendingClips.pop_front();
+        }
+    }
+    m_clipChanged.notify_all();
+
+    if (isPlayed)
+    {
+        m_pSoundOutput.write(sound);
+    }
+    if (isStored)
+    {
+        m_clipStore.Add(key, sound);
+    }
+}
+
+void HeadSynchronizer::onSynthesisState(const std::string &state)
+{
+    std::lock_guard<std::mutex> lock(m_clipMutex);
+    if (state.find("Failure") != std::string::npos || state.compare(0, 5, "Empty") == 0)
+    { // googleSynthesis gave up on the pending text, no audio will arrive for it
+        dropPendingClips("googleSynthesis answered " + state);
+    }
+    else if ((state == "Done" || state == "done") && m_pendingClips.empty() && !m_isSynthesisInSync)
+    { // Idle with nothing requested, so no late audio can be taken for the next text anymore
+        m_isSynthesisInSync = true;
+        yCInfo(HEAD_SYNCHRONIZER) << "googleSynthesis is idle again. The audio is stored again in the speech clip store.";
+    }
+}
+
+bool HeadSynchronizer::prepareSpeech(const std::vector<std::string> &texts)
+{
+    if (!m_clipStore.IsOpen())
+    {
+        return false;
+    }
+    m_isVoiceStale = true; // The TourManager prepares the speech right after a language change, before speaking
+    std::lock_guard<std::mutex> lock(m_clipMutex);
+    for (const std::string &text : texts)
+    {
+        std::vector<std::string> sentences = SplitSentences(text, m_minSentenceLength); // Split as they will be spoken, so that the clips are found
+        m_preparedTexts.insert(m_preparedTexts.end(), sentences.begin(), sentences.end());
+    }
+    m_clipChanged.notify_all();
+    yCDebug(HEAD_SYNCHRONIZER) << "I will prepare the speech of" << texts.size() << "texts";
+    return true;
+}
+
+void HeadSynchronizer::prepareSpeechRun()
+{
+    std::unique_lock<std::mutex> lock(m_clipMutex);
+    while (!m_isStopping)
+    {
+        // Paused while an utterance is pending, so that a live text never waits behind a text synthesized in advance
+        m_clipChanged.wait(lock, [this]
+                           { return m_isStopping || (!m_preparedTexts.empty() && m_pendingUtterances.load() == 0); });
+        if (m_isStopping)
+        {
+            break;
+        }
+        std::string text = std::move(m_preparedTexts.front());
+        m_preparedTexts.pop_front();
+        lock.unlock();
+
+        SpeechClipStore::ClipKey key = SpeechClipStore::Key(getVoice(), text);
+        std::uint64_t id = m_clipStore.Contains(key) ? 0 : requestSynthesis(text, key, false);
+
+        lock.lock();
+        auto isDone = [this, id]
+        { return m_isStopping || std::none_of(m_pendingClips.begin(), m_pendingClips.end(), [id](const PendingClip &clip)
+                                              { return clip.id == id; }); };
+        // Its audio is waited for, so that the speech is never queued in googleSynthesis behind more than one of them
+        if (id != 0 && !m_clipChanged.wait_for(lock, std::chrono::duration<double>(m_synthesisTimeout), isDone))
+        {
+            dropPendingClips("its audio did not arrive in time");
+        }
     }
-    yCWarning(HEAD_SYNCHRONIZER) << "Player status failed to update. This should not happen. ";
-    return false;
 }
 
 bool HeadSynchronizer::writeToPort(const std::string &s, yarp::os::Port &port)
@@ -186,12 +636,45 @@ bool HeadSynchronizer::writeToPort(const std::string &s, yarp::os::Port &port, y
 
 bool HeadSynchronizer::say(const std::string &s)
 {
-    m_isSpeaking = true;
-    std::unique_lock<std::mutex> lck(m_mutex);
-    m_textBuffer.push_back(s);
-    lck.unlock();
-    yCDebug(HEAD_SYNCHRONIZER) << "I added to the buffer the text:" << s;
-    return true;
+    return sayUtterance(s) >= 0;
+}
+
+std::int64_t HeadSynchronizer::sayUtterance(const std::string &text)
+{
+    m_pendingUtterances++; // Before the push, so that the speech cannot end before it starts
+    std::uint64_t id = 0;
+    // The id is taken by the same atomic increment that takes the position in the queue, so that the ids follow the order
+    // of the queue and they are done in order, without a lock around the push
+    if (!m_utterances.TryPush({0, text}, [&id](Utterance &utterance, std::size_t position)
+                              { utterance.id = id = position + 1; }))
+    {
+        releaseUtterance();
+        updateSpeaking();
+        yCError(HEAD_SYNCHRONIZER) << "The speech queue is full. I dropped the text:" << text;
+        return -1;
+    }
+    updateSpeaking();
+    publishSpeechEvent("queued", id);
+    yCDebug(HEAD_SYNCHRONIZER) << "I added to the queue the text" << id << ":" << text;
+    return static_cast<std::int64_t>(id);
+}
+
+bool HeadSynchronizer::waitForUtterance(const std::int64_t id, const double timeout)
+{
+    std::unique_lock<std::mutex> lock(m_utteranceMutex);
+    if (id <= 0 || static_cast<std::uint64_t>(id) > m_utterances.GetPushCount())
+    {
+        yCWarning(HEAD_SYNCHRONIZER) << "Can't wait for the utterance" << id << ". It has never been queued.";
+        return false;
+    }
+    auto isDone = [this, id]
+    { return static_cast<std::uint64_t>(id) <= std::max(m_doneUtteranceId, m_resetUtteranceId.load()); };
+    if (timeout < 0.0)
+    {
+        m_utteranceDone.wait(lock, isDone);
+        return true;
+    }
+    return m_utteranceDone.wait_for(lock, std::chrono::duration<double>(timeout), isDone);
 }
 
 bool HeadSynchronizer::pauseSpeaking()
@@ -291,116 +774,154 @@ bool HeadSynchronizer::stopHearing()
 
 bool HeadSynchronizer::isSpeaking()
 {
-    return m_isSpeaking;
+    return m_isSpeaking.load();
 }
 
 bool HeadSynchronizer::isHearing()
 {
-    yarp::dev::AudioRecorderStatus *recorderStatus = m_pMicrophoneStatus.read();
-    if (recorderStatus)
-    {
-        return recorderStatus->enabled;
-    }
-    return false;
+    isStale(m_microphoneStatusTime, m_isMicrophoneStale, "microphone");
+    return m_isMicrophoneEnabled.load(std::memory_order_acquire);
 }
 
 bool HeadSynchronizer::reset()
 {
-    std::unique_lock<std::mutex> lck(m_mutex);
-    m_textBuffer.clear();
-    lck.unlock();
-    yCDebug(HEAD_SYNCHRONIZER) << "Cleared the text buffer";
-    writeToPort("clear", m_pPlayerOutput);
-    while (isAudioPlaying())
+    std::uint64_t resetId;
     {
-        yarp::os::Time::delay(0.1);
+        std::lock_guard<std::mutex> lock(m_utteranceMutex); // So that two resets cannot move the boundary back
+        resetId = std::max<std::uint64_t>(m_utterances.GetPushCount(), m_resetUtteranceId.load());
+        m_resetUtteranceId = resetId; // The queued utterances are dropped by updateModule as it pops them
+        m_utteranceDone.notify_all();
     }
-    yCDebug(HEAD_SYNCHRONIZER) << "Audio player finished playing";
-    happyFace();
-    if (stopHearing())
+    publishSpeechEvent("reset", resetId);
     {
-        yCInfo(HEAD_SYNCHRONIZER) << "Reset successfully";
-        return true;
+        std::lock_guard<std::mutex> lock(m_playerMutex); // Wakes the utterance waiting for the audio of its sentence
+        m_playerChanged.notify_all();
     }
-    else
     {
-        yCError(HEAD_SYNCHRONIZER) << "Reset failed";
-        return false;
+        std::lock_guard<std::mutex> lock(m_clipMutex);
+        for (PendingClip &clip : m_pendingClips)
+        {
+            clip.isPlayed = false; // Still stored when it arrives
+        }
     }
-}
+    yCDebug(HEAD_SYNCHRONIZER) << "Cleared the speech queue";
 
-bool HeadSynchronizer::changeEmotion(int i)
-{
-    yarp::os::Bottle bot;
-    bot.addString("emotion");
-    bot.addFloat32(i);
-    bool result = m_pFaceOutput.write(bot);
-    if (result)
+    // The player and the microphone are stopped in parallel, so that the reset takes a single round trip
+    std::future<bool> isMicrophoneStopped = std::async(std::launch::async, [this]
+                                                       { return stopHearing(); });
+    {
+        std::lock_guard<std::mutex> lock(m_faceMutex);
+        m_isFaceSent = false; // The happy face is sent even if unchanged
+    }
+    setHappyFace(false); // With the ears of the closed microphone
+    bool isFlushed = flushPlayer(++m_flushSequence);
+    if (isFlushed && isMicrophoneStopped.get())
     {
-        yCDebug(HEAD_SYNCHRONIZER) << "Emotion changed successfully to:" << i;
+        yCInfo(HEAD_SYNCHRONIZER) << "Reset successfully";
         return true;
     }
     else
     {
-        yCError(HEAD_SYNCHRONIZER) << "Emotion failed to change";
+        yCError(HEAD_SYNCHRONIZER) << "Reset failed";
         return false;
     }
 }
 
-bool HeadSynchronizer::colorEars(int r, int g, int b)
+bool HeadSynchronizer::flushPlayer(std::uint64_t flush)
 {
-    yarp::os::Bottle bot;
-    bot.addString("color_ears");
-    bot.addFloat32(r);
-    bot.addFloat32(g);
-    bot.addFloat32(b);
-    bool result = m_pFaceOutput.write(bot);
-    if (result)
-    {
-        yCDebug(HEAD_SYNCHRONIZER) << "Ears color changed successfully to:" << r << g << b;
+    yarp::os::Bottle ack;
+    if (writeToPort("clear", m_pPlayerOutput, ack) && ack.get(0).asVocab32() == VOCAB_OK)
+    { // The buffer of the player is empty once it acknowledges, without waiting for its next status
+        m_acknowledgedFlush.store(flush);
+        m_isAudioPlaying.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_playerMutex);
+            m_playerChanged.notify_all();
+        }
+        yCDebug(HEAD_SYNCHRONIZER) << "Flush" << flush << "acknowledged by the audio player";
         return true;
     }
-    else
-    {
-        yCError(HEAD_SYNCHRONIZER) << "Ears color failed to change";
-        return false;
-    }
+
+    yCWarning(HEAD_SYNCHRONIZER) << "Flush" << flush << "not acknowledged by the audio player within" << m_flushTimeout << "seconds.";
+    return false;
 }
 
-bool HeadSynchronizer::colorMouth(int r, int g, int b)
+bool HeadSynchronizer::FaceState::operator==(const FaceState &other) const
 {
+    return emotion == other.emotion && ears == other.ears && mouth == other.mouth &&
+           isBlinking == other.isBlinking && isTalking == other.isTalking;
+}
+
+bool HeadSynchronizer::updateFace(const std::function<void(FaceState &)> &change)
+{
+    std::lock_guard<std::mutex> lock(m_faceMutex); // So that the states are sent in the order they are made
+    FaceState face = m_face;
+    change(face);
+    if (m_isFaceSent && face == m_face)
+    {
+        return true; // Unchanged, e.g. on the repeated statuses of googleSpeech
+    }
+
     yarp::os::Bottle bot;
-    bot.addString("color_mouth");
-    bot.addFloat32(r);
-    bot.addFloat32(g);
-    bot.addFloat32(b);
-    bool result = m_pFaceOutput.write(bot);
-    if (result)
+    bot.addString("face_state");
+    bot.addInt32(face.emotion);
+    yarp::os::Bottle &ears = bot.addList();
+    yarp::os::Bottle &mouth = bot.addList();
+    for (std::size_t i = 0; i < 3; i++)
     {
-        yCDebug(HEAD_SYNCHRONIZER) << "Mouth color changed successfully to:" << r << g << b;
-        return true;
+        ears.addInt32(face.ears[i]);
+        mouth.addInt32(face.mouth[i]);
     }
-    else
+    bot.addInt32(face.isBlinking ? 1 : 0);
+    bot.addInt32(face.isTalking ? 1 : 0);
+    if (!m_pFaceOutput.write(bot))
     {
-        yCError(HEAD_SYNCHRONIZER) << "Mouth color failed to change";
+        yCError(HEAD_SYNCHRONIZER) << "Face state failed to change";
         return false;
     }
+    m_face = face;
+    m_isFaceSent = true;
+    yCDebug(HEAD_SYNCHRONIZER) << "Face state changed successfully to:" << bot.toString();
     return true;
 }
 
+bool HeadSynchronizer::changeEmotion(int i)
+{
+    return updateFace([i](FaceState &face)
+                      { face.emotion = i; });
+}
+
+bool HeadSynchronizer::colorEars(int r, int g, int b)
+{
+    return updateFace([r, g, b](FaceState &face)
+                      { face.ears = {r, g, b}; });
+}
+
+bool HeadSynchronizer::colorMouth(int r, int g, int b)
+{
+    return updateFace([r, g, b](FaceState &face)
+                      { face.mouth = {r, g, b}; });
+}
+
 bool HeadSynchronizer::sadFaceWarning()
 {
-    changeEmotion(2);
-    colorMouth(238, 210, 2); // Yellow alert color code
+    updateFace([](FaceState &face)
+               {
+                   face.emotion = 2;
+                   face.mouth = {238, 210, 2}; // Yellow alert color code
+               });
     yCInfo(HEAD_SYNCHRONIZER) << "Changed to warning face";
     return true;
 }
 
 bool HeadSynchronizer::sadFaceError()
 {
-    changeEmotion(0);
-    colorEars(255, 0, 0);
-    colorMouth(255, 0, 0);
+    updateFace([](FaceState &face)
+               {
+                   face.emotion = 0;
+                   face.ears = {255, 0, 0};
+                   face.mouth = {255, 0, 0};
+               });
     m_isError = true;
     yCInfo(HEAD_SYNCHRONIZER) << "Changed to error face";
     return true;
@@ -408,9 +929,12 @@ bool HeadSynchronizer::sadFaceError()
 
 bool HeadSynchronizer::busyFaceError()
 {
-    changeEmotion(2);
-    colorEars(255, 0, 0);
-    colorMouth(255, 0, 0);
+    updateFace([](FaceState &face)
+               {
+                   face.emotion = 2;
+                   face.ears = {255, 0, 0};
+                   face.mouth = {255, 0, 0};
+               });
     m_isError = true;
     yCInfo(HEAD_SYNCHRONIZER) << "Changed to error face";
     return true;
@@ -418,29 +942,78 @@ bool HeadSynchronizer::busyFaceError()
 
 bool HeadSynchronizer::happyFace()
 {
-    changeEmotion(1);
-    if (isHearing())
-    {
-        colorEars(0, 128, 0);
-    }
-    else
-    {
-        colorEars(0, 0, 255);
-    }
-    colorMouth(0, 128, 0);
-    m_isError = false;
+    setHappyFace(isHearing()); // Cached status, it does not wait for the microphone
     yCInfo(HEAD_SYNCHRONIZER) << "Changed to happy face";
     return true;
 }
 
+void HeadSynchronizer::setHappyFace(bool isHearing)
+{
+    updateFace([isHearing](FaceState &face)
+               {
+                   face.emotion = 1;
+                   face.ears = isHearing ? std::array<int, 3>{0, 128, 0} : std::array<int, 3>{0, 0, 255};
+                   face.mouth = {0, 128, 0};
+               });
+    m_isError = false;
+}
+
 bool HeadSynchronizer::busyFace()
 {
-    changeEmotion(2);
-    colorMouth(255, 255, 255);
+    updateFace([](FaceState &face)
+               {
+                   face.emotion = 2;
+                   face.mouth = {255, 255, 255};
+               });
     yCInfo(HEAD_SYNCHRONIZER) << "Changed to busy face";
     return true;
 }
 
+PlayerStatusCallback::PlayerStatusCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
+{
+}
+
+void PlayerStatusCallback::onRead(yarp::dev::AudioPlayerStatus &status)
+{
+    m_headSynchronizer->onPlayerStatus(status);
+}
+
+MicrophoneStatusCallback::MicrophoneStatusCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
+{
+}
+
+void MicrophoneStatusCallback::onRead(yarp::dev::AudioRecorderStatus &status)
+{
+    m_headSynchronizer->onMicrophoneStatus(status);
+}
+
+SynthesisSoundCallback::SynthesisSoundCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
+{
+}
+
+void SynthesisSoundCallback::onRead(yarp::sig::Sound &sound)
+{
+    m_headSynchronizer->onSynthesisSound(sound);
+}
+
+SynthesisStateCallback::SynthesisStateCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
+{
+}
+
+void SynthesisStateCallback::onRead(yarp::os::Bottle &state)
+{
+    m_headSynchronizer->onSynthesisState(state.get(0).asString());
+}
+
+LanguageCallback::LanguageCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
+{
+}
+
+void LanguageCallback::onRead(yarp::os::Bottle &language)
+{
+    m_headSynchronizer->onLanguageChanged(language);
+}
+
 StatusCallback::StatusCallback(HeadSynchronizer *headSynchronizer) : m_headSynchronizer(headSynchronizer)
 {
 }
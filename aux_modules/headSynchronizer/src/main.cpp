@@ -1,6 +1,7 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/RFModule.h>
 #include <headSynchronizer.h>
+#include <tourClock.h>
 #include <yarp/os/LogStream.h>
 
 int main(int argc, char *argv[])
@@ -9,6 +10,11 @@ int main(int argc, char *argv[])
 
     yarp::os::ResourceFinder rf;
     rf.configure(argc, argv);
+    if (!ConfigureClock(rf))
+    {
+        yError() << "Invalid clock options!";
+        return EXIT_FAILURE;
+    }
     std::string name = rf.check("name") ? rf.find("name").asString() : "HeadSynchronizer";
 
     HeadSynchronizer synchronizer(name);
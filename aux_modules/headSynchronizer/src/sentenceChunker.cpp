@@ -0,0 +1,60 @@
+#include <sentenceChunker.h>
+
+namespace
+{
+    bool IsSentenceEnd(char c)
+    {
+        return c == '.' || c == '!' || c == '?' || c == ';';
+    }
+
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    void AddTrimmed(const std::string &text, std::size_t begin, std::size_t end, std::vector<std::string> &sentences)
+    {
+        while (begin < end && IsSpace(text[begin]))
+        {
+            begin++;
+        }
+        while (end > begin && IsSpace(text[end - 1]))
+        {
+            end--;
+        }
+        if (begin < end)
+        {
+            sentences.push_back(text.substr(begin, end - begin));
+        }
+    }
+}
+
+std::vector<std::string> SplitSentences(const std::string &text, std::size_t minLength)
+{
+    std::vector<std::string> sentences;
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i + 1 < text.size(); i++)
+    {
+        // The whole run of punctuation ends the sentence, e.g. "?!" or "..."
+        if (IsSentenceEnd(text[i]) && IsSpace(text[i + 1]) && i + 1 - begin >= minLength)
+        {
+            AddTrimmed(text, begin, i + 1, sentences);
+            begin = i + 1;
+        }
+    }
+
+    std::vector<std::string> tail;
+    AddTrimmed(text, begin, text.size(), tail);
+    if (!tail.empty())
+    {
+        if (!sentences.empty() && tail.front().size() < minLength)
+        {
+            sentences.back() += " " + tail.front(); // A short tail is joined to the last sentence
+        }
+        else
+        {
+            sentences.push_back(std::move(tail.front()));
+        }
+    }
+    return sentences;
+}
@@ -0,0 +1,299 @@
+#include <speechClipStore.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+YARP_LOG_COMPONENT(SPEECH_CLIP_STORE, "behavior_tour_robot.aux_modules.head_synchronizer.speech_clip_store", yarp::os::Log::TraceType)
+
+namespace
+{
+    constexpr char INDEX_MAGIC[8] = {'C', 'L', 'I', 'P', 'I', 'D', 'X', '2'}; // 2 stores the identity of the key with the clip
+    constexpr std::uint32_t MAX_CAPACITY = std::uint32_t(1) << 31;
+}
+
+SpeechClipStore::~SpeechClipStore()
+{
+    Close();
+}
+
+bool SpeechClipStore::Open(const std::string &directory, std::uint32_t capacity)
+{
+    Close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string indexPath = directory + "/index.bin";
+    std::string clipsPath = directory + "/clips.bin";
+    m_indexFile = ::open(indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+    m_clipsFile = ::open(clipsPath.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat indexStat;
+    if (m_indexFile < 0 || m_clipsFile < 0 || fstat(m_indexFile, &indexStat) != 0)
+    {
+        yCError(SPEECH_CLIP_STORE) << "Cannot open the speech clip store in" << directory;
+        Release();
+        return false;
+    }
+
+    if (indexStat.st_size > 0)
+    {
+        if (!MapIndex(static_cast<std::size_t>(indexStat.st_size)))
+        {
+            yCError(SPEECH_CLIP_STORE) << "Cannot map the index of the speech clip store in" << directory;
+            Release();
+            return false;
+        }
+        if (!IsIndexValid())
+        { // The capacity is used as a mask, so a wrong one would probe outside of the index
+            yCWarning(SPEECH_CLIP_STORE) << "The index in" << directory << "is not a valid speech clip store. It is created again empty.";
+            munmap(m_index, m_indexSize);
+            m_index = nullptr;
+        }
+    }
+    if (!m_index && !CreateIndex(capacity))
+    {
+        yCError(SPEECH_CLIP_STORE) << "Cannot create the speech clip store in" << directory;
+        Release();
+        return false;
+    }
+    yCInfo(SPEECH_CLIP_STORE) << "Opened the speech clip store in" << directory << "with" << m_header->count << "clips";
+    return true;
+}
+
+bool SpeechClipStore::MapIndex(std::size_t size)
+{
+    void *index = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_indexFile, 0);
+    if (index == MAP_FAILED)
+    {
+        return false;
+    }
+    m_index = index;
+    m_indexSize = size;
+    m_header = static_cast<IndexHeader *>(m_index);
+    m_entries = reinterpret_cast<IndexEntry *>(m_header + 1);
+    return true;
+}
+
+bool SpeechClipStore::IsIndexValid() const
+{
+    if (m_indexSize < sizeof(IndexHeader) || std::memcmp(m_header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+    {
+        return false;
+    }
+    std::uint32_t capacity = m_header->capacity;
+    return capacity > 0 && (capacity & (capacity - 1)) == 0 && m_header->count < capacity &&
+           m_indexSize == sizeof(IndexHeader) + static_cast<std::size_t>(capacity) * sizeof(IndexEntry);
+}
+
+bool SpeechClipStore::CreateIndex(std::uint32_t capacity)
+{
+    if (capacity == 0 || capacity > MAX_CAPACITY)
+    {
+        yCError(SPEECH_CLIP_STORE) << "The capacity of the speech clip store must be between 1 and" << MAX_CAPACITY;
+        return false;
+    }
+    std::uint32_t roundedCapacity = 1;
+    while (roundedCapacity < capacity)
+    {
+        roundedCapacity <<= 1;
+    }
+    std::size_t size = sizeof(IndexHeader) + static_cast<std::size_t>(roundedCapacity) * sizeof(IndexEntry);
+    // The clips of a discarded index cannot be found anymore, so they are dropped with it
+    if (ftruncate(m_clipsFile, 0) != 0 || ftruncate(m_indexFile, 0) != 0 || ftruncate(m_indexFile, static_cast<off_t>(size)) != 0 || !MapIndex(size))
+    {
+        return false;
+    }
+    std::memcpy(m_header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    m_header->capacity = roundedCapacity;
+    m_header->count = 0;
+    return true;
+}
+
+void SpeechClipStore::Close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Release();
+}
+
+void SpeechClipStore::Release()
+{
+    if (m_index)
+    {
+        munmap(m_index, m_indexSize);
+        m_index = nullptr;
+    }
+    m_indexSize = 0;
+    m_header = nullptr;
+    m_entries = nullptr;
+    if (m_indexFile >= 0)
+    {
+        ::close(m_indexFile);
+        m_indexFile = -1;
+    }
+    if (m_clipsFile >= 0)
+    {
+        ::close(m_clipsFile);
+        m_clipsFile = -1;
+    }
+}
+
+bool SpeechClipStore::IsOpen() const
+{
+    return m_index != nullptr;
+}
+
+SpeechClipStore::ClipKey SpeechClipStore::Key(const Voice &voice, const std::string &text)
+{
+    // FNV-1a of all the parameters, separated so that they cannot be confused with each other
+    ClipKey key;
+    key.identity = voice.language + '\n' + voice.voice + '\n' + std::to_string(voice.pitch) + '\n' + std::to_string(voice.speed) + '\n' + text;
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key.identity)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    key.hash = hash == 0 ? 1 : hash; // 0 marks the empty entries
+    return key;
+}
+
+SpeechClipStore::IndexEntry *SpeechClipStore::FindEntry(std::uint64_t hash)
+{
+    std::uint32_t mask = m_header->capacity - 1;
+    for (std::uint32_t i = hash & mask;; i = (i + 1) & mask) // Never full, so there always is an empty entry
+    {
+        if (m_entries[i].key == hash || m_entries[i].key == 0)
+        {
+            return &m_entries[i];
+        }
+    }
+}
+
+bool SpeechClipStore::ReadClip(const IndexEntry &entry, const ClipKey &key, std::size_t size, std::vector<char> &outData)
+{
+    std::size_t prefixSize = sizeof(ClipHeader) + key.identity.size();
+    if (entry.key != key.hash || entry.size < prefixSize || size < prefixSize || size > entry.size)
+    {
+        return false;
+    }
+    outData.resize(size);
+    if (pread(m_clipsFile, outData.data(), outData.size(), static_cast<off_t>(entry.offset)) != static_cast<ssize_t>(outData.size()))
+    {
+        yCWarning(SPEECH_CLIP_STORE) << "Cannot read the clip" << key.hash;
+        return false;
+    }
+    ClipHeader header;
+    std::memcpy(&header, outData.data(), sizeof(ClipHeader));
+    return header.identitySize == key.identity.size() &&
+           std::memcmp(outData.data() + sizeof(ClipHeader), key.identity.data(), key.identity.size()) == 0;
+}
+
+bool SpeechClipStore::Contains(const ClipKey &key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_index)
+    {
+        return false;
+    }
+    std::vector<char> data;
+    return ReadClip(*FindEntry(key.hash), key, sizeof(ClipHeader) + key.identity.size(), data); // Only the identity is read
+}
+
+bool SpeechClipStore::Find(const ClipKey &key, yarp::sig::Sound &outSound)
+{
+    std::vector<char> data;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_index)
+        {
+            return false;
+        }
+        const IndexEntry *entry = FindEntry(key.hash);
+        if (!ReadClip(*entry, key, entry->size, data))
+        {
+            return false;
+        }
+    }
+
+    ClipHeader header;
+    std::memcpy(&header, data.data(), sizeof(ClipHeader));
+    std::size_t samplesOffset = sizeof(ClipHeader) + header.identitySize;
+    if (data.size() != samplesOffset + header.samples * header.channels * sizeof(std::int16_t))
+    {
+        yCWarning(SPEECH_CLIP_STORE) << "The clip" << key.hash << "is corrupted";
+        return false;
+    }
+
+    const char *samples = data.data() + samplesOffset;
+    outSound.resize(header.samples, header.channels);
+    outSound.setFrequency(static_cast<int>(header.frequency));
+    for (std::uint64_t i = 0; i < header.samples; i++)
+    {
+        for (std::uint32_t channel = 0; channel < header.channels; channel++)
+        {
+            std::int16_t sample;
+            std::memcpy(&sample, samples, sizeof(sample));
+            samples += sizeof(sample);
+            outSound.set(sample, i, channel);
+        }
+    }
+    return true;
+}
+
+bool SpeechClipStore::Add(const ClipKey &key, const yarp::sig::Sound &sound)
+{
+    ClipHeader header;
+    header.frequency = static_cast<std::uint32_t>(sound.getFrequency());
+    header.channels = static_cast<std::uint32_t>(sound.getChannels());
+    header.samples = sound.getSamples();
+    header.identitySize = key.identity.size();
+    std::vector<char> data(sizeof(ClipHeader) + key.identity.size() + header.samples * header.channels * sizeof(std::int16_t));
+    std::memcpy(data.data(), &header, sizeof(ClipHeader));
+    std::memcpy(data.data() + sizeof(ClipHeader), key.identity.data(), key.identity.size());
+    char *samples = data.data() + sizeof(ClipHeader) + key.identity.size();
+    for (std::uint64_t i = 0; i < header.samples; i++)
+    {
+        for (std::uint32_t channel = 0; channel < header.channels; channel++)
+        {
+            std::int16_t sample = static_cast<std::int16_t>(sound.get(i, channel));
+            std::memcpy(samples, &sample, sizeof(sample));
+            samples += sizeof(sample);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_index)
+    {
+        return false;
+    }
+    IndexEntry *entry = FindEntry(key.hash);
+    if (entry->key == key.hash)
+    {
+        std::vector<char> identity;
+        if (ReadClip(*entry, key, sizeof(ClipHeader) + key.identity.size(), identity))
+        {
+            return true;
+        }
+        yCWarning(SPEECH_CLIP_STORE) << "Another clip has the same hash" << key.hash << ". The clip is not stored.";
+        return false;
+    }
+    if (m_header->count + 1 > m_header->capacity / 4 * 3) // Keeps the probing short
+    {
+        yCWarning(SPEECH_CLIP_STORE) << "The speech clip store is full. The clip is not stored.";
+        return false;
+    }
+
+    off_t offset = lseek(m_clipsFile, 0, SEEK_END);
+    if (offset < 0 || pwrite(m_clipsFile, data.data(), data.size(), offset) != static_cast<ssize_t>(data.size()))
+    {
+        yCWarning(SPEECH_CLIP_STORE) << "Cannot write the clip" << key.hash;
+        return false;
+    }
+    entry->offset = static_cast<std::uint64_t>(offset);
+    entry->size = data.size();
+    entry->key = key.hash; // Last, so that the entry is complete once it can be found
+    m_header->count++;
+    return true;
+}
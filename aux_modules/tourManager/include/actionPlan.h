@@ -0,0 +1,90 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_ACTION_PLAN_H
+#define BEHAVIOR_TOUR_ROBOT_ACTION_PLAN_H
+
+#include "action.h"
+#include "stringPool.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MovementsContainer;
+
+enum class SignalTypes
+{
+    START_HEARING,
+    SET_LANGUAGE,
+    NEXT_POI,
+    RESET,
+    DELAY,
+    INVALID = -1
+};
+
+/**
+ * A signal action with its parameter already parsed.
+ * The voice and the language are views into the parsed parameter.
+ */
+struct SignalCommand
+{
+    SignalTypes type{SignalTypes::INVALID};
+    float delay{0.0f};    // Seconds to wait, for DELAY
+    std::string_view voice;    // Voice of the synthesizer, e.g. en-US-Wavenet-C, for SET_LANGUAGE
+    std::string_view language; // Language code, e.g. en-US, for SET_LANGUAGE
+
+    /**
+     * Parses the parameter of a signal action: startHearing, nextPoi, reset, setLanguage_<voice> or delay_<seconds>
+     * @param param the parameter of the action. Must outlive the signal
+     * @return the parsed signal, with an INVALID type if the parameter is not a valid signal
+     */
+    static SignalCommand Parse(std::string_view param);
+};
+
+/**
+ * A single action of a compiled ActionPlan.
+ */
+struct PlanStep
+{
+    ActionTypes type{ActionTypes::INVALID};
+    std::string_view param;    // Text to speak or name of the dance, pooled in the owning TourModel
+    float danceDuration{0.0f}; // Total duration of the dance, precomputed from the movements
+    SignalCommand signal;
+};
+
+/**
+ * A group of steps executed together, up to and including the first blocking one.
+ */
+struct PlanGroup
+{
+    int begin{0};         // First step of the group
+    int end{0};           // One past the last step of the group
+    bool isWaited{true};  // True if the execution waits for the speech and the dances of the group to finish
+};
+
+/**
+ * The actions of a command compiled at load time into a flat sequence of steps.
+ * Signals are parsed, blocking groups and dance durations are precomputed, so that
+ * executing a command is a linear walk over the steps.
+ */
+class ActionPlan
+{
+private:
+    std::vector<PlanStep> m_steps;
+    std::vector<PlanGroup> m_groups;
+
+public:
+    ActionPlan() = default;
+
+    /**
+     * Constructor
+     *
+     * @param actions the actions of the command, in execution order
+     * @param movements the movements used to precompute the dance durations. If nullptr, the durations are 0
+     * @param strings the pool where the parameters are stored. Must outlive the plan
+     */
+    ActionPlan(const std::vector<Action> &actions, const MovementsContainer *movements, StringPool &strings);
+
+    [[nodiscard]] const std::vector<PlanStep> &getSteps() const;
+    [[nodiscard]] const std::vector<PlanGroup> &getGroups() const;
+    [[nodiscard]] bool empty() const;
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_ACTION_PLAN_H
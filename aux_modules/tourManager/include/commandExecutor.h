@@ -0,0 +1,115 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_COMMAND_EXECUTOR_H
+#define BEHAVIOR_TOUR_ROBOT_COMMAND_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+enum class CommandPriority
+{
+    IDLE = 0,   // Chatter of the tour itself, e.g. while navigating
+    DIALOG = 1, // Answers to the visitors
+    ERROR = 2   // Errors notified by the skills
+};
+
+/**
+ * Flag shared between the executor and a running command, so that the command can be aborted.
+ * A default constructed token is never cancelled.
+ */
+class CancellationToken
+{
+private:
+    std::shared_ptr<std::atomic<bool>> m_isCancelled;
+
+public:
+    CancellationToken() = default;
+
+    /**
+     * @return a token that can be cancelled
+     */
+    [[nodiscard]] static CancellationToken Create();
+
+    void Cancel() const;
+    [[nodiscard]] bool IsCancelled() const;
+
+    /**
+     * @return true if both tokens can be cancelled and are copies of the same token
+     */
+    [[nodiscard]] bool IsSameAs(const CancellationToken &other) const;
+};
+
+/**
+ * Runs the commands of the TourManager one at a time on its own thread, highest priority first.
+ *
+ * A command with a higher priority than the running one cancels it, so that e.g. an error is
+ * handled right away instead of waiting for the end of a long speech. A command already waiting
+ * in the queue with the same priority is not queued twice, unless it is posted as not coalesced.
+ */
+class CommandExecutor
+{
+public:
+    using Handler = std::function<bool(const std::string &command, const CancellationToken &token)>;
+
+    explicit CommandExecutor(Handler handler);
+    ~CommandExecutor();
+
+    CommandExecutor(const CommandExecutor &) = delete;
+    CommandExecutor &operator=(const CommandExecutor &) = delete;
+
+    void Start();
+
+    /**
+     * Cancels the running command and discards the queued ones
+     */
+    void Stop();
+
+    /**
+     * Queues a command and returns immediately
+     * @param isCoalesced false to queue the command even if the same one is already waiting, e.g. when every occurrence counts
+     * @return the result of the command once it has been executed, false if it is discarded
+     */
+    std::shared_future<bool> Post(const std::string &command, CommandPriority priority, bool isCoalesced = true);
+
+    /**
+     * Queues a command and waits for its execution. If called by a command being executed, it is executed immediately
+     * @return the result of the command
+     */
+    bool Execute(const std::string &command, CommandPriority priority);
+
+private:
+    struct Item
+    {
+        std::string command;
+        CommandPriority priority;
+        std::uint64_t sequence; // Keeps the order of arrival between the commands with the same priority
+        std::shared_ptr<std::promise<bool>> result;
+        std::shared_future<bool> future;
+
+        bool operator<(const Item &other) const
+        {
+            return priority != other.priority ? priority > other.priority : sequence < other.sequence;
+        }
+    };
+
+    Handler m_handler;
+    std::mutex m_mutex;
+    std::condition_variable m_hasItems;
+    std::set<Item> m_queue; // Ordered by priority, then by arrival
+    std::uint64_t m_nextSequence{0};
+    bool m_isRunning{false};
+    bool m_isBusy{false};
+    CommandPriority m_runningPriority{CommandPriority::IDLE};
+    CancellationToken m_runningToken;
+    std::thread m_thread;
+
+    void Run();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_COMMAND_EXECUTOR_H
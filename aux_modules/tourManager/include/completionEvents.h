@@ -0,0 +1,157 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_COMPLETION_EVENTS_H
+#define BEHAVIOR_TOUR_ROBOT_COMPLETION_EVENTS_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <navigation.h>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+
+/**
+ * Latest speech and navigation status, updated by the notifications of the headSynchronizer and
+ * of the NavigationMonitor. The waits wake up as soon as the status changes, instead of polling.
+ */
+class CompletionEvents
+{
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_isSpeaking{false};
+    bool m_hasSpeechEvents{false}; // True once a speech status has been received from the headSynchronizer
+    bool m_isSpeakingNotified{false};
+    double m_speechStartTime{-1.0};
+    bool m_hasUtteranceEvents{false}; // True once an utterance event has been received from the headSynchronizer
+    std::int64_t m_doneUtterance{0};  // Latest utterance finished or dropped by a reset
+    yarp::dev::Nav2D::NavigationStatusEnum m_navigationStatus{yarp::dev::Nav2D::navigation_status_idle};
+
+public:
+    /**
+     * Sets the speech status as known locally, e.g. right after a text has been queued
+     */
+    void SetSpeaking(bool isSpeaking);
+
+    /**
+     * Sets the speech status notified by the headSynchronizer
+     */
+    void OnSpeechEvent(bool isSpeaking);
+
+    /**
+     * Sets the progress of an utterance notified by the headSynchronizer
+     * @param event "queued", "synthesis", "started", "finished" or "reset"
+     * @param id the id of the utterance. For "reset" the latest utterance dropped
+     */
+    void OnUtteranceEvent(const std::string &event, std::int64_t id);
+
+    [[nodiscard]] bool IsSpeaking();
+    [[nodiscard]] bool HasSpeechEvents();
+    [[nodiscard]] bool HasUtteranceEvents();
+
+    /**
+     * @return the time when the headSynchronizer last notified that it started speaking, negative if it never did
+     */
+    [[nodiscard]] double GetSpeechStartTime();
+
+    /**
+     * Waits until the speech status is notified to be idle
+     * @param timeout the maximum time to wait in seconds
+     * @return true if the speech is idle, false on timeout
+     */
+    bool WaitSpeechIdle(double timeout);
+
+    /**
+     * Waits until an utterance is notified to be finished or dropped
+     * @param id the id returned by sayUtterance
+     * @param timeout the maximum time to wait in seconds
+     * @return true if the utterance is done, false on timeout
+     */
+    bool WaitUtterance(std::int64_t id, double timeout);
+
+    void SetNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum status);
+    [[nodiscard]] yarp::dev::Nav2D::NavigationStatusEnum GetNavigationStatus();
+
+    /**
+     * Waits until the navigation status is one of the given ones
+     * @param statuses the accepted statuses
+     * @param timeout the maximum time to wait in seconds, negative to wait forever
+     * @param outStatus the status that woke up the wait
+     * @return true if the status is one of the accepted ones, false on timeout
+     */
+    bool WaitNavigationStatus(std::initializer_list<yarp::dev::Nav2D::NavigationStatusEnum> statuses, double timeout, yarp::dev::Nav2D::NavigationStatusEnum &outStatus);
+};
+
+/**
+ * Receives the speech status notifications ("speaking" or "idle") of the headSynchronizer.
+ */
+class SpeechStatusCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+public:
+    SpeechStatusCallback(CompletionEvents &events);
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle &b) override;
+
+private:
+    CompletionEvents &m_events;
+};
+
+/**
+ * Receives the utterance events ("<event> <id> <time>") of the headSynchronizer.
+ */
+class SpeechEventsCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+public:
+    SpeechEventsCallback(CompletionEvents &events);
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle &b) override;
+
+private:
+    CompletionEvents &m_events;
+};
+
+/**
+ * Reads the navigation status on its own thread and notifies the changes, so that the tour steps
+ * never poll the navigation themselves. It is suspended while no navigation is active.
+ */
+class NavigationMonitor : public yarp::os::PeriodicThread
+{
+public:
+    /**
+     * Polls the navigation status as long as it is alive. Nested scopes keep polling until the last one ends
+     */
+    class ActiveScope
+    {
+    public:
+        explicit ActiveScope(NavigationMonitor &monitor);
+        ~ActiveScope();
+
+        ActiveScope(const ActiveScope &) = delete;
+        ActiveScope &operator=(const ActiveScope &) = delete;
+
+    private:
+        NavigationMonitor &m_monitor;
+    };
+
+    NavigationMonitor(CompletionEvents &events, double period);
+    void SetNavigation(NavigationInterface *navigation);
+
+    /**
+     * Reads the navigation status now if it is not being polled, so that the status of the events is current
+     */
+    void Refresh();
+
+    void run() override;
+
+private:
+    CompletionEvents &m_events;
+    NavigationInterface *m_navigation{nullptr};
+    std::mutex m_activeMutex;
+    int m_activeScopes{0};
+
+    void Activate();
+    void Deactivate();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_COMPLETION_EVENTS_H
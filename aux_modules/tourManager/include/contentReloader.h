@@ -0,0 +1,81 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_CONTENT_RELOADER_H
+#define BEHAVIOR_TOUR_ROBOT_CONTENT_RELOADER_H
+
+#include <tourStorage.h>
+#include <movementStorage.h>
+#include <yarp/os/PeriodicThread.h>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Loads the tour and the movements into their storages and hot reloads them while the module is running.
+ *
+ * The thread watches the modification time of the content files and reloads them when they change,
+ * or when a reload is requested with Reload(). The new tour and movements are both built on this
+ * thread and then published by the storages with an atomic swap, so readers are never blocked. If
+ * either of them is not valid, neither is published and the previous content is kept.
+ */
+class ContentReloader : public yarp::os::PeriodicThread
+{
+private:
+    std::string m_pathJSONTours;
+    std::string m_pathJSONMovements;
+    std::string m_pathSnapshot;
+    std::string m_tourName;
+    std::vector<std::string> m_languages;
+    bool m_watchFiles;
+
+    timespec m_toursTime{};
+    timespec m_movementsTime{};
+    timespec m_snapshotTime{};
+
+    std::mutex m_requestMutex;
+    std::condition_variable m_requestDone;
+    unsigned m_requested{0}; // Number of requested reloads
+    unsigned m_served{0};    // Number of reloads served to the requesters
+    bool m_lastResult{false};
+
+    bool UpdateFileTimes();
+    bool IsSnapshotFresh() const;
+    bool LoadFromSnapshot();
+    bool LoadFromJSON();
+    bool Publish(std::unique_ptr<MovementsContainer> movements, std::unique_ptr<const TourModel> tour);
+
+public:
+    /**
+     * Constructor
+     *
+     * @param pathJSONTours the path of the json tours file
+     * @param pathJSONMovements the path of the json movements file
+     * @param pathSnapshot the path of the precompiled snapshot. If empty, only the json files are used
+     * @param tourName the name of the tour to load
+     * @param languages the languages of the tour to load. If empty, all of them are loaded
+     */
+    ContentReloader(const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &pathSnapshot, const std::string &tourName, const std::vector<std::string> &languages);
+
+    /**
+     * Loads the content for the first time, preferring the snapshot if it is available
+     * @return true if both the tour and the movements have been loaded
+     */
+    bool Load();
+
+    /**
+     * Requests a reload of the content to the thread and waits for it
+     * @param timeout the maximum time to wait in seconds
+     * @return true if the new content has been loaded. On failure the previous content is still in use
+     */
+    bool Reload(double timeout);
+
+    /**
+     * @param watchFiles true to reload the content automatically when the files are modified
+     * @param period the period of the file watcher in seconds
+     */
+    void SetWatch(bool watchFiles, double period);
+
+    void run() override;
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_CONTENT_RELOADER_H
@@ -0,0 +1,119 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_CTP_DISPATCHER_H
+#define BEHAVIOR_TOUR_ROBOT_CTP_DISPATCHER_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Port.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Sends the movement commands to the ctpService of every robot part concurrently.
+ *
+ * Every part has its own queue and worker thread, so the blocking writes of different parts
+ * run in parallel while the movements of the same part keep their order. For every dance the
+ * start skew, i.e. the time between the first and the last part receiving its first movement,
+ * is measured and reported.
+ */
+class CtpDispatcher
+{
+public:
+    /**
+     * The movements of a single dance, dispatched together
+     */
+    class Batch
+    {
+    private:
+        friend class CtpDispatcher;
+
+        std::string m_name;
+        std::mutex m_mutex;
+        bool m_isSealed{false};   // True once all the movements of the dance have been queued
+        int m_pendingParts{0};    // Parts whose first movement has been queued but not received yet
+        int m_startedParts{0};    // Parts that received their first movement
+        double m_firstStart{0.0}; // Time at which the first part received its first movement
+        double m_lastStart{0.0};  // Time at which the last part received its first movement
+
+    public:
+        explicit Batch(std::string name);
+    };
+
+    CtpDispatcher() = default;
+    ~CtpDispatcher();
+
+    CtpDispatcher(const CtpDispatcher &) = delete;
+    CtpDispatcher &operator=(const CtpDispatcher &) = delete;
+
+    /**
+     * Adds a part and starts its worker
+     * @param part the name of the robot part
+     * @param port the rpc port connected to the ctpService of the part. Must outlive the dispatcher
+     */
+    void AddPart(const std::string &part, yarp::os::Port &port);
+
+    /**
+     * Stops all the workers. The movements still in the queues are discarded
+     */
+    void Stop();
+
+    /**
+     * @return true if the part has been added
+     */
+    [[nodiscard]] bool HasPart(const std::string &part) const;
+
+    /**
+     * Queues a movement command to the worker of its part and returns immediately
+     * @param part the name of the robot part
+     * @param command the pre-encoded ctpService command, shared and never copied
+     * @param batch the dance the movement belongs to
+     * @return false if the part does not exist
+     */
+    bool Dispatch(const std::string &part, const std::shared_ptr<const yarp::os::Bottle> &command, const std::shared_ptr<Batch> &batch);
+
+    /**
+     * Marks the batch as complete, so that its skew can be reported once all of its parts started
+     * @param batch the dance whose movements have all been dispatched
+     */
+    void Seal(const std::shared_ptr<Batch> &batch);
+
+    /**
+     * Logs the statistics of the start skew of all the dances dispatched so far
+     */
+    void LogStatistics();
+
+private:
+    struct Job
+    {
+        std::shared_ptr<const yarp::os::Bottle> command; // Keeps the command alive even if the movements are reloaded meanwhile
+        std::shared_ptr<Batch> batch;
+        bool isFirst{false}; // True for the first movement of the batch for this part
+    };
+
+    struct Worker
+    {
+        std::string part;
+        yarp::os::Port *port{nullptr};
+        std::mutex mutex;
+        std::condition_variable hasJobs;
+        std::deque<Job> jobs;
+        std::shared_ptr<Batch> lastBatch; // Last batch queued, to detect the first movement of a batch for this part
+        bool isStopping{false};
+        std::thread thread;
+    };
+
+    std::map<std::string, std::unique_ptr<Worker>> m_workers;
+    std::mutex m_statisticsMutex;
+    int m_batchesNum{0};
+    double m_skewSum{0.0};
+    double m_skewMax{0.0};
+
+    void Run(Worker &worker);
+    void OnFirstMovement(Batch &batch, double time);
+    void ReportIfComplete(Batch &batch);
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_CTP_DISPATCHER_H
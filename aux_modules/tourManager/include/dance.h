@@ -59,14 +59,25 @@ public:
     [[nodiscard]] float GetDuration() const;
 
     /**
-     * @return a copy of the vector of all the movement in this dance
+     * @return the vector of all the movement in this dance
      */
-    [[nodiscard]] std::vector<Movement> GetMovements() const;
+    [[nodiscard]] const std::vector<Movement> &GetMovements() const;
+
+    /**
+     * Encodes the ctpService commands of all the movements of the dance
+     */
+    void BuildCommands();
 
     /**
      * Updates the internal total duration of the dance object
      */
     void UpdateDuration();
+
+    /**
+     * Sets the internal total duration of the dance object to a precomputed value
+     * @param duration the total duration of the dance
+     */
+    void SetDuration(float duration);
 };
 
 #endif // BEHAVIOR_TOUR_ROBOT_DANCE_H
@@ -0,0 +1,101 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_JOB_POOL_H
+#define BEHAVIOR_TOUR_ROBOT_JOB_POOL_H
+
+#include <commandExecutor.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class JobStatus
+{
+    PENDING,
+    RUNNING,
+    SUCCEEDED,
+    FAILED,
+    CANCELLED,
+    UNKNOWN = -1
+};
+
+/**
+ * Runs the long requests of the RPC interface on a pool of worker threads, so that the RPC
+ * returns a job id immediately and its outcome can be queried later with the id.
+ */
+class JobPool
+{
+public:
+    using JobId = std::int32_t;
+    using Task = std::function<bool(const CancellationToken &token)>; // Returns the success of the job
+
+    JobPool() = default;
+    ~JobPool();
+
+    JobPool(const JobPool &) = delete;
+    JobPool &operator=(const JobPool &) = delete;
+
+    /**
+     * Starts the workers
+     * @param workersNum the number of jobs that can run at the same time
+     */
+    void Start(int workersNum);
+
+    /**
+     * Cancels the pending jobs and waits for the running ones to end
+     */
+    void Stop();
+
+    /**
+     * Queues a job
+     * @param name the name of the job, used for logging
+     * @param task the function run by the job
+     * @return the id of the job, or -1 if the pool is not running
+     */
+    JobId Submit(const std::string &name, Task task);
+
+    /**
+     * @return the status of the job, UNKNOWN if the id does not exist or has been forgotten
+     */
+    [[nodiscard]] JobStatus GetStatus(JobId id);
+
+    /**
+     * Cancels a job. A pending job does not run, a running job is notified through its cancellation token
+     * @param outToken if not null, set to the token of the job when it is running
+     * @return false if the job does not exist or has already ended
+     */
+    bool Cancel(JobId id, CancellationToken *outToken = nullptr);
+
+    [[nodiscard]] static std::string ToString(JobStatus status);
+
+private:
+    struct Job
+    {
+        JobId id{-1};
+        std::string name;
+        Task task;
+        JobStatus status{JobStatus::PENDING};
+        CancellationToken token{CancellationToken::Create()};
+    };
+
+    static constexpr size_t MAX_ENDED_JOBS = 64; // Ended jobs kept to answer the status queries
+
+    std::mutex m_mutex;
+    std::condition_variable m_hasJobs;
+    std::map<JobId, std::shared_ptr<Job>> m_jobs;
+    std::deque<std::shared_ptr<Job>> m_queue;
+    std::deque<JobId> m_endedJobs;
+    std::vector<std::thread> m_workers;
+    JobId m_nextId{0};
+    bool m_isRunning{false};
+
+    void Run();
+    void End(Job &job, JobStatus status); // Must be called holding the mutex
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_JOB_POOL_H
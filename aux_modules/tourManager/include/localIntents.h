@@ -0,0 +1,123 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_LOCAL_INTENTS_H
+#define BEHAVIOR_TOUR_ROBOT_LOCAL_INTENTS_H
+
+#include <tourModel.h>
+#include <rcuPointer.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Immutable trigram index of the example phrases of the commands of a language.
+ *
+ * A transcription is matched against all the phrases at once through the inverted index from the
+ * character trigrams to the phrases containing them, and scored with the Dice coefficient of their trigrams.
+ */
+class IntentIndex
+{
+public:
+    struct Intent
+    {
+        std::string command;
+        std::vector<std::string> phrases;
+        bool isGeneric{false};               // Available in every PoI
+        std::unordered_set<std::string> pois; // PoIs where it is available, if not generic
+    };
+
+    struct Match
+    {
+        std::string command; // Empty if no phrase shares a trigram with the text
+        double score{0.0};   // Similarity of the best phrase, from 0 to 1
+        double runnerUp{0.0}; // Similarity of the best phrase of any other command
+    };
+
+    explicit IntentIndex(const std::vector<Intent> &intents);
+
+    /**
+     * @param text the transcription of the visitor
+     * @param poiName the current PoI. Only the commands available in it are matched
+     */
+    [[nodiscard]] Match Find(const std::string &text, const std::string &poiName) const;
+
+    /**
+     * @return the text in lower case, with the punctuation removed and the spaces collapsed
+     */
+    [[nodiscard]] static std::string Normalize(const std::string &text);
+
+private:
+    std::vector<Intent> m_intents;
+    std::vector<int> m_phraseIntents;        // Intent of every phrase
+    std::vector<int> m_phraseTrigramsNum;    // Number of distinct trigrams of every phrase
+    std::unordered_map<std::uint32_t, std::vector<int>> m_postings; // Phrases containing every trigram
+
+    static std::vector<std::uint32_t> Trigrams(const std::string &text);
+};
+
+/**
+ * Local stage of the dialog: the transcriptions that confidently match an example phrase are executed
+ * right away, without the round trip to googleDialog. The others are still sent to googleDialog.
+ *
+ * The phrases are read from a json file with the phrases of every command in every language:
+ *     { "it-IT": { "nextPoi": ["andiamo avanti", "prossima opera"], ... }, "en-US": { ... } }
+ */
+class LocalIntents
+{
+public:
+    /**
+     * Loads the example phrases
+     * @param path the path of the json file
+     * @param threshold the minimum similarity, from 0 to 1, of a confident match
+     * @return false if the file cannot be read
+     */
+    bool Load(const std::string &path, double threshold);
+    [[nodiscard]] bool IsLoaded() const;
+
+    /**
+     * Builds the index of the commands of a language, keeping only the ones available in the tour
+     * @param tour the tour model
+     * @param languageSet the PoIs of the language
+     */
+    void SetLanguage(const TourModel &tour, const LanguageSet &languageSet);
+
+    /**
+     * Matches a transcription
+     * @param text the transcription of the visitor
+     * @param poiName the current PoI
+     * @param outCommand the command to execute if the match is confident
+     * @return true if the match is confident, false if the text has to be sent to googleDialog
+     */
+    bool Match(const std::string &text, const std::string &poiName, std::string &outCommand);
+
+    /**
+     * Notifies that a text has been sent to googleDialog, to measure its round trip
+     */
+    void OnForwarded();
+
+    /**
+     * Notifies that a command has been received from googleDialog
+     */
+    void OnDialogResult();
+
+    /**
+     * Logs the hit rate of the local stage and the estimated latency it saved
+     */
+    void LogStatistics();
+
+private:
+    std::map<std::string, std::map<std::string, std::vector<std::string>>> m_phrases; // Phrases of every command of every language
+    double m_threshold{0.8};
+    double m_margin{0.1}; // Minimum distance from the best phrase of another command, so that similar commands go to googleDialog
+    RcuPointer<IntentIndex> m_index;
+
+    std::atomic<std::uint64_t> m_utterances{0};
+    std::atomic<std::uint64_t> m_hits{0};
+    std::atomic<double> m_forwardTime{-1.0}; // Time of the last text sent to googleDialog and not answered yet
+    std::atomic<std::uint64_t> m_roundTrips{0};
+    std::atomic<std::int64_t> m_roundTripMicroseconds{0};
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_LOCAL_INTENTS_H
@@ -0,0 +1,91 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_LOCATION_CACHE_H
+#define BEHAVIOR_TOUR_ROBOT_LOCATION_CACHE_H
+
+#include <navigation.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Local copy of the coordinates of the PoIs stored in the map server.
+ *
+ * All the locations are resolved when the cache is started, so that the navigation does not need
+ * a round trip to the map server for every goal. A background thread refreshes them every refresh
+ * period, so that the locations changed on the map server replace the cached ones, and resolves
+ * the prefetched locations as soon as they are requested.
+ */
+class LocationCache
+{
+public:
+    LocationCache() = default;
+    ~LocationCache();
+
+    LocationCache(const LocationCache &) = delete;
+    LocationCache &operator=(const LocationCache &) = delete;
+
+    /**
+     * Resolves all the locations and starts the refresh thread
+     * @param navigation the navigation used to query the map server. Must outlive the cache
+     * @param refreshPeriod the time in seconds after which all the locations are resolved again
+     */
+    void Start(NavigationInterface *navigation, double refreshPeriod);
+
+    /**
+     * Stops the refresh thread
+     */
+    void Stop();
+
+    /**
+     * Sets the locations to keep in the cache. The ones not cached yet are resolved in background
+     * @param names the names of the locations, i.e. the names of the PoIs
+     */
+    void SetNames(const std::vector<std::string> &names);
+
+    /**
+     * Gets the coordinates of a location from the cache, or from the map server if it is not cached
+     * @param name the name of the location
+     * @param outLocation the coordinates of the location
+     * @return false if the location does not exist on the map server
+     */
+    bool Get(const std::string &name, yarp::dev::Nav2D::Map2DLocation &outLocation);
+
+    /**
+     * Resolves again a location in background, so that it is fresh when it will be used
+     * @param name the name of the location
+     */
+    void Prefetch(const std::string &name);
+
+    /**
+     * Removes a location from the cache, so that the next Get resolves it from the map server
+     * @param name the name of the location
+     */
+    void Invalidate(const std::string &name);
+
+    /**
+     * Logs the hits and misses of the cache
+     */
+    void LogStatistics();
+
+private:
+    NavigationInterface *m_navigation{nullptr};
+    double m_refreshPeriod{10.0};
+    std::mutex m_mutex;
+    std::condition_variable m_hasRequests;
+    std::map<std::string, yarp::dev::Nav2D::Map2DLocation> m_locations;
+    std::vector<std::string> m_names;
+    std::deque<std::string> m_requests; // Locations to resolve as soon as possible
+    bool m_isStopping{false};
+    std::thread m_thread;
+    int m_hits{0};
+    int m_misses{0};
+
+    bool Resolve(const std::string &name); // Round trip to the map server. Must be called without holding the mutex
+    void Refresh();
+    void Run();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_LOCATION_CACHE_H
@@ -2,8 +2,10 @@
 #ifndef BEHAVIOR_TOUR_ROBOT_MOVEMENT_H
 #define BEHAVIOR_TOUR_ROBOT_MOVEMENT_H
 
+#include <memory>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include <yarp/os/Bottle.h>
 
 using json = nlohmann::json;
 
@@ -14,6 +16,7 @@ private:
     float m_offset;
     std::string m_partName;
     std::vector<float> m_joints;
+    std::shared_ptr<const yarp::os::Bottle> m_command; // Pre-encoded ctpService command, shared with the dispatch queues
 
 public:
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(Movement, m_time, m_offset, m_partName, m_joints)
@@ -58,8 +61,18 @@ public:
 
     [[nodiscard]] float GetTime() const;
     [[nodiscard]] float GetOffset() const;
-    [[nodiscard]] std::string GetPartName() const;
-    [[nodiscard]] std::vector<float> GetJoints() const;
+    [[nodiscard]] const std::string &GetPartName() const;
+    [[nodiscard]] const std::vector<float> &GetJoints() const;
+
+    /**
+     * Encodes the ctpService command of the movement once, so that it can be sent many times without rebuilding it
+     */
+    void BuildCommand();
+
+    /**
+     * @return the ctpService command of the movement or nullptr if BuildCommand() has not been called
+     */
+    [[nodiscard]] const std::shared_ptr<const yarp::os::Bottle> &GetCommand() const;
 };
 
 #endif // BEHAVIOR_TOUR_ROBOT_MOVEMENT_H
@@ -7,6 +7,8 @@
 #include <nlohmann/json.hpp>
 #include <movement.h>
 #include <dance.h>
+#include <tourSnapshot.h>
+#include <rcuPointer.h>
 #include <fstream>
 #include <iostream>
 
@@ -58,8 +60,15 @@ public:
     MovementsContainer &operator=(const MovementsContainer &m) = default;
 
     [[nodiscard]] std::set<std::string>& GetPartNames();
+    [[nodiscard]] const std::set<std::string>& GetPartNames() const;
     [[nodiscard]] std::map<std::string, Dance>& GetDances();
+    [[nodiscard]] const std::map<std::string, Dance>& GetDances() const;
     [[nodiscard]] bool GetDance(const std::string &danceName, Dance &outDance) const;
+
+    /**
+     * @return a pointer to the dance or nullptr if it does not exist
+     */
+    [[nodiscard]] const Dance *FindDance(const std::string &danceName) const;
 };
 
 class MovementStorage
@@ -68,10 +77,14 @@ private:
     MovementStorage() {}
     ~MovementStorage() {}
 
-    MovementsContainer m_movementsContainer;
+    RcuPointer<MovementsContainer> m_movementsContainer; // Swapped atomically on reload
 
 public:
+    using ContainerGuard = RcuPointer<MovementsContainer>::ReadGuard;
+
+    static MovementStorage &GetInstance();
     static MovementStorage &GetInstance(const std::string &pathJSONMovements);
+    static MovementStorage &GetInstance(const TourSnapshot &snapshot);
 
     MovementStorage(const MovementStorage &) = delete;
     MovementStorage &operator=(const MovementStorage &) = delete;
@@ -80,7 +93,26 @@ public:
 
     nlohmann::ordered_json ReadFileAsJSON(const std::string &path);
     bool LoadMovements(const std::string &pathJSONMovements);
-    MovementsContainer &GetMovementsContainer();
+    bool LoadMovements(const TourSnapshot &snapshot);
+
+    /**
+     * Builds the movements without publishing them, so that they can be published together with a new tour
+     * @return the movements with their commands encoded, nullptr if they cannot be read or are not valid
+     */
+    std::unique_ptr<MovementsContainer> BuildMovements(const std::string &pathJSONMovements);
+    std::unique_ptr<MovementsContainer> BuildMovements(const TourSnapshot &snapshot);
+
+    /**
+     * Publishes the movements built by BuildMovements. Readers that pinned the previous container keep using it until they release it
+     */
+    void Publish(std::unique_ptr<MovementsContainer> movementsContainer);
+
+    /**
+     * Pins the currently loaded movements. Never blocks, even while new movements are being loaded.
+     * The container stays valid as long as the returned guard is alive.
+     * @return the guard of the container, empty if no movements were loaded
+     */
+    ContainerGuard GetMovementsContainer() const;
 };
 
 #endif // BEHAVIOR_TOUR_ROBOT_MOVEMENT_STORAGE_H
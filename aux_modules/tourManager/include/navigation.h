@@ -0,0 +1,44 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_NAVIGATION_H
+#define BEHAVIOR_TOUR_ROBOT_NAVIGATION_H
+
+#include <yarp/dev/INavigation2D.h>
+#include <string>
+
+/**
+ * The navigation operations used by the TourManager.
+ * On the robot they are forwarded to the navigation client by Nav2DNavigation, while the tools
+ * (e.g. the tourBenchmark) provide stand-ins that need neither a robot nor a map server.
+ */
+class NavigationInterface
+{
+public:
+    virtual ~NavigationInterface() = default;
+
+    virtual bool getLocation(const std::string &locationName, yarp::dev::Nav2D::Map2DLocation &location) = 0;
+    virtual bool gotoTargetByLocationName(const std::string &locationName) = 0;
+    virtual bool getNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum &status) = 0;
+    virtual bool stopNavigation() = 0;
+    virtual bool suspendNavigation(double time) = 0;
+    virtual bool resumeNavigation() = 0;
+};
+
+/**
+ * NavigationInterface forwarding to a yarp navigation client
+ */
+class Nav2DNavigation : public NavigationInterface
+{
+private:
+    yarp::dev::Nav2D::INavigation2D *m_iNav2D;
+
+public:
+    explicit Nav2DNavigation(yarp::dev::Nav2D::INavigation2D *iNav2D);
+
+    bool getLocation(const std::string &locationName, yarp::dev::Nav2D::Map2DLocation &location) override;
+    bool gotoTargetByLocationName(const std::string &locationName) override;
+    bool getNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum &status) override;
+    bool stopNavigation() override;
+    bool suspendNavigation(double time) override;
+    bool resumeNavigation() override;
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_NAVIGATION_H
@@ -71,6 +71,7 @@ public:
     bool getActions(const std::string &command, std::vector<Action> &actions);
 
     std::vector<std::string> getAvailableCommands();
+    [[nodiscard]] const std::unordered_map<std::string, std::vector<Action>> &getAvailableActions() const;
     int getCommandMultiplesNum(const std::string &command);
 };
 
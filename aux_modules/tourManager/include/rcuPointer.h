@@ -0,0 +1,176 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_RCU_POINTER_H
+#define BEHAVIOR_TOUR_ROBOT_RCU_POINTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * Read-copy-update holder of an immutable object.
+ *
+ * Readers pin the currently published object with a ReadGuard, which only costs two atomic
+ * increments and never takes a lock. Every guard, nested or not, holds its own reader count, so the
+ * object it pinned stays alive until that guard is released. Writers publish a new object with an
+ * atomic pointer swap and then sleep, on their own thread, until every reader that could still see
+ * the old object is gone before deleting it.
+ */
+template <typename T>
+class RcuPointer
+{
+private:
+    std::atomic<const T *> m_current{nullptr};
+    std::atomic<std::uint64_t> m_generation{0};
+    mutable std::atomic<unsigned> m_epoch{0};
+    mutable std::atomic<int> m_readers[2] = {{0}, {0}};
+    std::mutex m_writeMutex; // Serializes the writers only
+
+    // Only used to wake the writer, the readers lock it only when they release the last pin the writer waits for
+    mutable std::atomic<bool> m_isWriterWaiting{false};
+    mutable std::mutex m_waitMutex;
+    mutable std::condition_variable m_readersDone;
+
+    void unpin(int slot) const
+    {
+        if (m_readers[slot].fetch_sub(1) == 1 && m_isWriterWaiting.load())
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_readersDone.notify_all();
+        }
+    }
+
+public:
+    class ReadGuard
+    {
+    private:
+        friend class RcuPointer;
+
+        const RcuPointer *m_owner{nullptr};
+        const T *m_object{nullptr};
+        std::uint64_t m_generation{0};
+        int m_slot{-1}; // Reader counter incremented by this guard, -1 for empty guards
+
+        ReadGuard(const RcuPointer *owner) : m_owner(owner)
+        {
+            while (true)
+            {
+                unsigned epoch = owner->m_epoch.load();
+                owner->m_readers[epoch & 1].fetch_add(1);
+                if (owner->m_epoch.load() == epoch)
+                {
+                    m_slot = epoch & 1;
+                    break;
+                }
+                owner->unpin(epoch & 1); // A writer flipped the epoch meanwhile, retry
+            }
+            m_generation = owner->m_generation.load();
+            m_object = owner->m_current.load();
+        }
+
+        void release()
+        {
+            if (m_owner && m_slot >= 0)
+            {
+                m_owner->unpin(m_slot);
+            }
+            m_owner = nullptr;
+            m_object = nullptr;
+            m_slot = -1;
+        }
+
+    public:
+        ReadGuard() = default;
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+        ReadGuard(ReadGuard &&other) noexcept : m_owner(other.m_owner),
+                                                m_object(other.m_object),
+                                                m_generation(other.m_generation),
+                                                m_slot(other.m_slot)
+        {
+            other.m_owner = nullptr;
+            other.m_object = nullptr;
+            other.m_slot = -1;
+        }
+
+        ReadGuard &operator=(ReadGuard &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_owner = other.m_owner;
+                m_object = other.m_object;
+                m_generation = other.m_generation;
+                m_slot = other.m_slot;
+                other.m_owner = nullptr;
+                other.m_object = nullptr;
+                other.m_slot = -1;
+            }
+            return *this;
+        }
+
+        ~ReadGuard()
+        {
+            release();
+        }
+
+        const T *get() const { return m_object; }
+        const T &operator*() const { return *m_object; }
+        const T *operator->() const { return m_object; }
+        explicit operator bool() const { return m_object != nullptr; }
+
+        /**
+         * @return the number of the publication of the pinned object, starting from 1
+         */
+        std::uint64_t generation() const { return m_generation; }
+    };
+
+    RcuPointer() = default;
+    RcuPointer(const RcuPointer &) = delete;
+    RcuPointer &operator=(const RcuPointer &) = delete;
+
+    ~RcuPointer()
+    {
+        delete m_current.load();
+    }
+
+    /**
+     * Pins the currently published object. Never blocks, also when nested in another guard on the same thread.
+     */
+    ReadGuard read() const
+    {
+        return ReadGuard(this);
+    }
+
+    /**
+     * @return the number of the last publication. Lock free, can be used to cheaply detect updates
+     */
+    std::uint64_t generation() const
+    {
+        return m_generation.load();
+    }
+
+    /**
+     * Publishes a new object and deletes the previous one once no reader can access it anymore.
+     * Blocks the calling thread until then, so it must not be called while holding a ReadGuard.
+     */
+    void publish(std::unique_ptr<const T> object)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const T *previous = m_current.exchange(object.release());
+        m_generation.fetch_add(1);
+
+        unsigned epoch = m_epoch.fetch_add(1); // New readers now increment the other counter
+        {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_isWriterWaiting = true; // Seen by the last reader to release, or the count is seen as zero here
+            m_readersDone.wait(lock, [this, epoch]
+                               { return m_readers[epoch & 1].load() == 0; });
+            m_isWriterWaiting = false;
+        }
+        delete previous;
+    }
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_RCU_POINTER_H
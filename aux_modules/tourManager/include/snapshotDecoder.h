@@ -0,0 +1,185 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_SNAPSHOT_DECODER_H
+#define BEHAVIOR_TOUR_ROBOT_SNAPSHOT_DECODER_H
+
+#include "movementStorage.h"
+#include "tour.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * Base SAX handler of the snapshot blobs. It keeps track of where the parser is, so that the derived
+ * decoders can build the model objects straight from the MessagePack events, without a json DOM.
+ * The containers a decoder is not interested in are only tokenized.
+ */
+class SnapshotDecoder : public nlohmann::json_sax<nlohmann::json>
+{
+private:
+    std::vector<std::string> m_keys; // Key of every open container in its parent, empty for the array elements and the root
+    std::vector<bool> m_isArray;     // Kind of every open container
+    std::string m_key;               // Last key read in the innermost open object
+    int m_skipDepth{-1};             // Depth of the skipped container, -1 if not skipping
+    std::string m_error;
+
+    bool startContainer(bool isArray);
+    bool endContainer();
+    bool addValue(const nlohmann::json &value);
+
+protected:
+    /**
+     * Called when a container is opened
+     * @param isArray true for an array, false for an object
+     * @return true to decode the container, false to skip it
+     */
+    virtual bool enter(bool isArray) = 0;
+
+    /**
+     * Called when a decoded container is closed, before it is removed from the path
+     * @return false to stop parsing
+     */
+    virtual bool leave() = 0;
+
+    /**
+     * Called for every scalar of a decoded container
+     * @param value the scalar
+     * @return false to stop parsing
+     */
+    virtual bool value(const nlohmann::json &value) = 0;
+
+    /**
+     * Stops the parsing with an error
+     * @return always false
+     */
+    bool fail(const std::string &error);
+
+    /**
+     * @return the number of open containers, including the one just entered or about to be left
+     */
+    [[nodiscard]] int depth() const;
+
+    /**
+     * @param level the depth of the container, starting from 1 for the root
+     * @return the key of the container in its parent, empty for the array elements and the root
+     */
+    [[nodiscard]] const std::string &keyAt(int level) const;
+
+    /**
+     * @return the key of the current value in the innermost open object, empty inside an array
+     */
+    [[nodiscard]] const std::string &currentKey() const;
+
+public:
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t &s) override;
+    bool string(string_t &val) override;
+    bool binary(binary_t &val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t &val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string &last_token, const nlohmann::detail::exception &ex) override;
+
+    /**
+     * @return the error that stopped the parsing, empty if none occurred
+     */
+    [[nodiscard]] const std::string &getError() const;
+};
+
+/**
+ * Decodes a tour blob, with the same structure as a tour of the tours json file, into a Tour
+ */
+class TourDecoder : public SnapshotDecoder
+{
+private:
+    std::set<std::string> m_enabledLanguages; // If empty all the languages are decoded
+    std::unordered_map<std::string, std::unordered_map<std::string, PoI>> m_availablePoIs;
+    std::vector<std::string> m_activeTourPoIs;
+    bool m_hasAvailablePoIs{false};
+    bool m_hasActiveTourPoIs{false};
+
+    std::string m_poiName;
+    bool m_hasPoIName{false};
+    bool m_hasAvailableActions{false};
+    std::unordered_map<std::string, std::vector<Action>> m_availableActions;
+    std::vector<Action> m_actions; // Actions of the command being decoded
+
+    ActionTypes m_type{ActionTypes::INVALID};
+    bool m_isBlocking{false};
+    std::string m_param;
+    int m_actionFields{0}; // Bitmask of the fields of the action being decoded
+
+protected:
+    bool enter(bool isArray) override;
+    bool leave() override;
+    bool value(const nlohmann::json &value) override;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param enabledLanguages the languages to keep. If empty, all the languages of the tour are kept
+     */
+    TourDecoder(const std::vector<std::string> &enabledLanguages);
+
+    /**
+     * @return true if the tour has both the available and the active PoIs
+     */
+    [[nodiscard]] bool isComplete() const;
+
+    /**
+     * @return the decoded tour. Only valid if isComplete() is true
+     */
+    [[nodiscard]] Tour getTour();
+};
+
+/**
+ * Decodes the movements blob, i.e. the movements json file and the precomputed dance durations,
+ * into a MovementsContainer
+ */
+class MovementsDecoder : public SnapshotDecoder
+{
+private:
+    std::set<std::string> m_partNames;
+    std::map<std::string, Dance> m_dances;
+    std::map<std::string, float> m_durations;
+    bool m_hasMovements{false};
+    bool m_hasPartNames{false};
+    bool m_hasDances{false};
+
+    bool m_hasDanceMovements{false};
+    std::vector<Movement> m_movements; // Movements of the dance being decoded
+    float m_time{0.0f};
+    float m_offset{0.0f};
+    std::string m_partName;
+    std::vector<float> m_joints;
+    int m_movementFields{0}; // Bitmask of the fields of the movement being decoded
+
+protected:
+    bool enter(bool isArray) override;
+    bool leave() override;
+    bool value(const nlohmann::json &value) override;
+
+public:
+    /**
+     * @return true if the movements have both the part names and the dances
+     */
+    [[nodiscard]] bool isComplete() const;
+
+    /**
+     * @return the decoded movements. Only valid if isComplete() is true
+     */
+    [[nodiscard]] MovementsContainer getMovements();
+
+    /**
+     * @return the precomputed duration of every dance, empty if the blob has none
+     */
+    [[nodiscard]] std::map<std::string, float> &getDurations();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_SNAPSHOT_DECODER_H
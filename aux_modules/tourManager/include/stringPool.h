@@ -0,0 +1,55 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_STRING_POOL_H
+#define BEHAVIOR_TOUR_ROBOT_STRING_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Append-only arena of deduplicated strings.
+ * Every distinct string is stored once, contiguously in large blocks, and handed out as a string_view
+ * that stays valid until the pool is destroyed. The pool itself is not thread safe: it is filled while
+ * the owner is built, then sealed and only read afterwards.
+ */
+class StringPool
+{
+public:
+    struct Statistics
+    {
+        std::size_t interned{0};       // Strings passed to Intern
+        std::size_t unique{0};         // Distinct strings stored
+        std::size_t separateBytes{0};  // Memory the interned strings would take as separate std::strings
+        std::size_t poolBytes{0};      // Memory taken by the blocks, the index and the handles
+    };
+
+    explicit StringPool(std::size_t blockSize = 4096);
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    /**
+     * @param text the string to store
+     * @return a view of the pooled copy of the string, the same for all the equal strings
+     */
+    std::string_view Intern(std::string_view text);
+
+    /**
+     * Frees the index used to find the equal strings. The strings added afterwards are not deduplicated
+     */
+    void Seal();
+
+    [[nodiscard]] Statistics GetStatistics() const;
+
+private:
+    std::size_t m_blockSize;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_block{nullptr};     // Block where the short strings are appended
+    std::size_t m_blockFree{0}; // Bytes still free at the end of m_block
+    std::size_t m_allocatedBytes{0};
+    std::unordered_set<std::string_view> m_index;
+    Statistics m_statistics;
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_STRING_POOL_H
@@ -0,0 +1,162 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_TELEMETRY_H
+#define BEHAVIOR_TOUR_ROBOT_TELEMETRY_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/PeriodicThread.h>
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Histogram of durations with power of two buckets of microseconds.
+ * Recording is lock free, so it can be done from any thread in the middle of a command.
+ */
+class Histogram
+{
+public:
+    static constexpr int BUCKETS_NUM = 32; // The last bucket collects everything above 2^30 us, i.e. about 18 minutes
+
+    struct Summary
+    {
+        std::uint64_t count{0};
+        double mean{0.0}; // All the durations are in seconds
+        double p50{0.0};  // The percentiles are the upper bound of their bucket, so they are at most twice the real one
+        double p90{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    void Record(double seconds);
+    [[nodiscard]] Summary Summarize() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS_NUM> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sumMicroseconds{0};
+    std::atomic<std::uint64_t> m_maxMicroseconds{0};
+
+    [[nodiscard]] double Percentile(double quantile, std::uint64_t count, std::uint64_t maxMicroseconds) const;
+};
+
+/**
+ * The phases of a tour measured for every PoI
+ */
+enum class PoIMetric
+{
+    NAVIGATION,     // From the start of the navigation pose to the goal reached
+    SPEECH_START,   // From the text sent to the headSynchronizer to its speaking notification
+    SPEAKING,       // From the start of the speech to its end
+    DANCE,          // Time waited for the dances to end
+    ERROR_RECOVERY, // From an error sent by the skills to their recovered
+    METRICS_NUM
+};
+
+/**
+ * Timing telemetry of the tour.
+ *
+ * The durations are aggregated in process into histograms per PoI and per command, so that recording
+ * an event costs a few atomic operations. The commands are registered once when the telemetry is opened,
+ * the ones not registered, e.g. added by a later reload of the tour, share the histogram of the other commands. The thread publishes the cumulative histograms every period
+ * on a port and appends them as a json line to a rolling file.
+ */
+class Telemetry : public yarp::os::PeriodicThread
+{
+public:
+    /**
+     * Records the time from its construction to its destruction in a histogram
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram &histogram);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Histogram &m_histogram;
+        double m_startTime;
+    };
+
+    explicit Telemetry(double period);
+
+    /**
+     * Opens the port and the file where the telemetry is published
+     * @param portName the name of the output port
+     * @param filePath the path of the file. If empty, the telemetry is not written to a file
+     * @param maxFileSize the size in bytes after which the file is moved to filePath.1 and started again
+     * @param commands the names of the commands with their own histogram. Must be called before start
+     * @return false if the port cannot be opened
+     */
+    bool Open(const std::string &portName, const std::string &filePath, std::size_t maxFileSize, const std::vector<std::string> &commands);
+
+    /**
+     * Publishes the telemetry for the last time and closes the port and the file. Must be called after stop
+     */
+    void Close();
+
+    /**
+     * Sets the PoI the next metrics are recorded into
+     * @param name the name of the PoI
+     */
+    void SetPoI(const std::string &name);
+
+    /**
+     * Records a duration into the current PoI
+     */
+    void Record(PoIMetric metric, double seconds);
+
+    /**
+     * Counts a fallback of the dialog in the current PoI
+     */
+    void CountFallback();
+
+    /**
+     * @param command the name of the command
+     * @return the histogram of the durations of the command, or the one of the other commands if it was not registered.
+     * The reference stays valid as long as the telemetry
+     */
+    Histogram &GetCommandHistogram(const std::string &command);
+
+    void run() override;
+
+private:
+    struct PoIStatistics
+    {
+        std::array<Histogram, static_cast<size_t>(PoIMetric::METRICS_NUM)> metrics;
+        std::atomic<std::uint64_t> fallbacks{0};
+    };
+
+    static constexpr const char *OTHER_COMMANDS = "other";
+
+    std::mutex m_mutex; // Protects the map of the PoIs while it grows, not the statistics
+    std::map<std::string, PoIStatistics> m_poIs;
+    std::vector<std::string> m_commandNames;                  // Fixed when the telemetry is opened, then only read
+    std::unordered_map<std::string, size_t> m_commandIndices; // Index of every command in m_commandNames
+    std::unique_ptr<Histogram[]> m_commands;                  // Indexed as m_commandNames
+    Histogram m_otherCommands;
+    std::atomic<PoIStatistics *> m_currentPoI{nullptr};
+
+    std::mutex m_publishMutex;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_port;
+    std::string m_filePath;
+    std::size_t m_maxFileSize{0};
+    std::ofstream m_file;
+
+    static const char *ToString(PoIMetric metric);
+    static void AddSummary(const Histogram::Summary &summary, yarp::os::Bottle &bottle, nlohmann::json &json);
+    void Publish();
+    void WriteFile(const nlohmann::json &json);
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_TELEMETRY_H
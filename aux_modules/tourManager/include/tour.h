@@ -103,6 +103,12 @@ public:
      * @return an std::vector containing the active PoIs
      */
     [[nodiscard]] std::vector<std::string> getPoIsList() const;
+
+    /**
+     * Used to access all the PoIs of the tour without copying them
+     * @return a const reference to the PoIs of the tour per language
+     */
+    [[nodiscard]] const std::unordered_map<std::string, std::unordered_map<std::string, PoI>> &getAvailablePoIs() const;
 };
 
 #endif // BEHAVIOR_TOUR_ROBOT_TOUR_H
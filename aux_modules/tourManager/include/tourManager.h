@@ -3,6 +3,15 @@
 
 #include <tourStorage.h>
 #include <movementStorage.h>
+#include <contentReloader.h>
+#include <completionEvents.h>
+#include <ctpDispatcher.h>
+#include <navigation.h>
+#include <locationCache.h>
+#include <jobPool.h>
+#include <commandExecutor.h>
+#include <telemetry.h>
+#include <localIntents.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/RFModule.h>
 #include <yarp/os/Time.h>
@@ -13,28 +22,55 @@
 #include <tourManagerRPC.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/INavigation2D.h>
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <random>
 
 class DialogflowCallback;
+class TranscriptionCallback;
+
+/**
+ * Tour model pinned by a command, with the current language and PoI resolved in it.
+ * The pointers point into the model, so they are only valid as long as the view is alive
+ */
+struct TourView
+{
+    TourStorage::ModelGuard tour;
+    const LanguageSet *languageSet{nullptr}; // PoIs of the current language, nullptr if no language is selected
+    const PoIView *currentPoI{nullptr};
+    int poiIndex{0}; // Index of the current PoI in the active PoIs
+
+    explicit operator bool() const { return static_cast<bool>(tour); }
+    const TourModel &operator*() const { return *tour; }
+    const TourModel *operator->() const { return tour.get(); }
+};
+
 class TourManager : public yarp::os::RFModule, public tourManagerRPC
 {
 private:
     DialogflowCallback *m_dialogflowCallback;
+    TranscriptionCallback *m_transcriptionCallback{nullptr};
     std::string m_name;
     double m_period;
     bool m_hasReachedPoI;
     bool m_isFirstStart;
-    bool m_isSpeechInterrupted;
+    std::atomic<bool> m_isSpeechInterrupted; // Set by the errors, cleared by the command that repeats the interrupted sentence
     int m_fallback_threshold;
     int m_fallback_repeat_counter;
     TourStorage *m_tourStorage;
     MovementStorage *m_moveStorage;
-    PoI m_currentPoI;
-    PoI m_genericPoI;
+    ContentReloader m_contentReloader;
+    double m_reloadTimeout{30.0}; // Maximum time the reloadContent RPC waits for the reload to complete
+    // The position in the tour is kept by name and index, and resolved in the pinned model by AcquireTour. Protected by m_stateMutex
+    std::uint64_t m_tourGeneration; // Generation of the tour model the current PoI name was resolved in
+    std::string m_currentLanguageName; // Survives the reloads of the tour model
+    std::string m_currentPoIName; // Survives the reloads of the tour model
     int m_PoIndex;
     yarp::dev::Nav2D::Map2DLocation m_previousPoIloc;
     std::string m_previousPoIname;
-    std::string m_last_valid_speak;
+    std::string m_last_valid_speak; // Protected by m_stateMutex
+    std::string m_interruptedSpeak; // Sentence said again by the repeat command, protected by m_stateMutex
     std::mt19937 m_random_gen;
     std::default_random_engine m_rand_engine;
     std::uniform_int_distribution<std::mt19937::result_type> m_uniform_distrib;
@@ -50,6 +86,10 @@ private:
     std::string m_dialogflowInputName;
     std::string m_tourManagerThriftPortName;
     std::string m_defaultLanguage;
+    std::string m_speechStatusName;
+    std::string m_speechEventsName;
+    std::string m_transcriptionInputName;
+    std::string m_languageOutputName;
 
     headSynchronizerRPC m_headSynchronizer;
     yarp::os::Port m_pHeadSynchronizer;
@@ -59,25 +99,70 @@ private:
     yarp::os::Port m_pDialog;
     yarp::os::Port m_pDialogflowOutput;
     yarp::os::BufferedPort<yarp::os::Bottle> m_pDialogflowInput;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pSpeechStatus;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pSpeechEvents;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pTranscriptionInput;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_pLanguageOutput; // Notifies the language changes, so that the other modules never poll it
+    CompletionEvents m_events;
+    SpeechStatusCallback m_speechStatusCallback;
+    SpeechEventsCallback m_speechEventsCallback;
+    NavigationMonitor m_navigationMonitor;
     std::map<std::string, yarp::os::Port &> m_pCtpService;
+    CtpDispatcher m_ctpDispatcher;
     googleSpeech_IDL m_speech;
     googleDialog_IDL m_Dialog;
     googleSynthesis_IDL m_Synthesis;
     yarp::dev::PolyDriver m_nav2DPoly;
     yarp::dev::Nav2D::INavigation2D *m_iNav2D{nullptr};
+    std::unique_ptr<Nav2DNavigation> m_nav2DNavigation;
+    NavigationInterface *m_navigation{nullptr}; // Either the navigation client or the one given by the application
+    LocationCache m_locationCache;
+    bool m_isTransitionPipelined{false}; // Send the navigation goal while the arms move to the navigation pose
+    bool m_isPoseInterlocked{true};      // Hold the base until the navigation pose is reached when the transition is pipelined
+    JobPool m_jobPool;
+    std::mutex m_navigationMutex; // Only one navigation at a time, either synchronous or from a job
+    std::mutex m_navigationOwnerMutex; // Protects m_navigationOwner. Never held while navigating, unlike m_navigationMutex
+    CancellationToken m_navigationOwner; // Token of the job whose navigation is running, empty if none
+    std::mutex m_stateMutex;      // Protects the position in the tour, read by the commands, the jobs and the RPC queries
+    CommandExecutor m_commandExecutor;
+    double m_commandTick{0.05}; // Maximum time for a running command to notice that it has been cancelled
+    std::atomic<std::int64_t> m_waitMicroseconds{0}; // Time spent by the commands waiting for dances, delays and speech
+    Telemetry m_telemetry;
+    std::atomic<double> m_speakTime{-1.0}; // Time of the first text sent to the headSynchronizer and not waited yet
+    std::atomic<std::int64_t> m_lastUtterance{0}; // Id of the last text sent to the headSynchronizer, 0 if none
+    std::atomic<double> m_errorTime{-1.0}; // Time of the first error not recovered yet
+    LocalIntents m_localIntents;
 
 private:
-    void BlockSpeak();
+    void BlockSpeak(const CancellationToken &token = CancellationToken());
+    bool WaitFor(double duration, const CancellationToken &token);
     void Speak(const std::string &text, bool isValid);
+    std::string GetLastValidSpeak();
+    std::shared_future<bool> RepeatSpeech(const std::string &text);
     float DoDance(const std::string &movement);
     void Signal(const std::string &param);
-    bool SendMovement(float time, float offset, std::vector<float> joints, yarp::os::Port &port);
+    void Signal(const SignalCommand &signal, const CancellationToken &token = CancellationToken());
     void SendToDialogue(const std::string &command);
     bool NextPoI();
     bool UpdatePoI();
+    bool UpdateLanguage(const std::string &language);
+    bool SetServicesLanguage(const SignalCommand &signal);
+    bool OpenNavigation(yarp::os::ResourceFinder &rf);
+    TourView AcquireTour();
+    std::vector<std::string> GetActivePoINames(const TourModel &tour) const;
+    bool StartNavigation(const std::string &poiName, const CancellationToken &token);
+    void PrepareSpeech(const LanguageSet &languageSet);
+    bool NavigateToPoI(const CancellationToken &token);
 
 public:
-    TourManager(const std::string &name, const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &tourName);
+    TourManager(const std::string &name, const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &tourName, const std::vector<std::string> &languages = {}, const std::string &pathSnapshot = "");
+
+    /**
+     * Uses the given navigation instead of opening the navigation client, e.g. a stand-in without robot.
+     * Must be called before configure
+     * @param navigation the navigation to use. Must outlive the module
+     */
+    void SetNavigation(NavigationInterface *navigation);
 
     virtual bool configure(yarp::os::ResourceFinder &rf);
     virtual bool close();
@@ -85,13 +170,37 @@ public:
     virtual bool interruptModule();
     virtual bool updateModule();
 
-    bool InterpretCommand(const std::string &command);
+    bool InterpretCommand(const std::string &command, const CancellationToken &token = CancellationToken());
+    std::shared_future<bool> PostCommand(const std::string &command, CommandPriority priority);
+
+    /**
+     * Handles a transcription of the visitor: a confident local intent, if enabled, is executed right away, anything else is sent to googleDialog
+     * @param text the transcription
+     * @return the result of the command if it has been matched locally, an invalid future if it has been sent to googleDialog
+     */
+    std::shared_future<bool> OnTranscription(const std::string &text);
+
+    /**
+     * Handles a command received from googleDialog
+     * @param command the command
+     * @return the result of the command
+     */
+    std::shared_future<bool> OnDialogResult(const std::string &command);
+
+    /**
+     * @return the total time in seconds spent by the commands waiting for dances, delays and speech to end
+     */
+    [[nodiscard]] double GetWaitTime() const;
 
     bool sendError(const std::string &error) override;
     bool recovered() override;
     bool isAtPoI() override;
     bool sendToPoI() override;
     std::string getCurrentPoIName();
+    bool reloadContent() override;
+    std::int32_t sendToPoIAsync() override;
+    std::string getJobStatus(const std::int32_t jobId) override;
+    bool cancelJob(const std::int32_t jobId) override;
 };
 
 class DialogflowCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
@@ -105,4 +214,15 @@ private:
     TourManager *m_tourManager;
 };
 
+class TranscriptionCallback : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+public:
+    TranscriptionCallback(TourManager *tourManager);
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle &b) override;
+
+private:
+    TourManager *m_tourManager;
+};
+
 #endif // BEHAVIOR_TOUR_ROBOT_TOUR_MANAGER_H
\ No newline at end of file
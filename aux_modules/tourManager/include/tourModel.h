@@ -0,0 +1,166 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_TOUR_MODEL_H
+#define BEHAVIOR_TOUR_ROBOT_TOUR_MODEL_H
+
+#include "actionPlan.h"
+#include "stringPool.h"
+#include "tour.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using LanguageId = int;
+using PoIId = int;
+using CommandId = int;
+
+constexpr int INVALID_ID = -1;
+
+class TourModel;
+
+/**
+ * Read-only view of a PoI, in a given language, inside a TourModel.
+ * The commands are addressed by the ids interned by the owning model, and their actions
+ * are compiled into ActionPlans at load time, so looking up a command never copies them.
+ *
+ * The variants of a command ("greetings", "greetings1", "greetings2", ...) are grouped at load time
+ * in a contiguous range, so that a random variant can be selected in constant time.
+ */
+class PoIView
+{
+private:
+    friend class TourModel;
+
+    struct VariantRange
+    {
+        int begin{0}; // First entry in m_variantPlans
+        int count{0}; // Number of variants, 0 if the command is not available in this PoI
+    };
+
+    const TourModel *m_model{nullptr};
+    PoIId m_id{INVALID_ID};
+    std::vector<ActionPlan> m_plans;          // The compiled actions of every command of the PoI
+    std::vector<int> m_variantPlans;          // Indices in m_plans of the variants of every command, contiguous per command
+    std::vector<VariantRange> m_variants;     // Indexed by CommandId
+
+public:
+    PoIView() = default;
+
+    [[nodiscard]] PoIId getId() const;
+    [[nodiscard]] const std::string &getName() const;
+
+    [[nodiscard]] bool isCommandValid(CommandId command) const;
+    [[nodiscard]] bool isCommandValid(const std::string &command) const;
+
+    /**
+     * @param command the id of the command
+     * @return a pointer to the plan of the command or nullptr if the command is not available in this PoI
+     */
+    [[nodiscard]] const ActionPlan *getPlan(CommandId command) const;
+    [[nodiscard]] const ActionPlan *getPlan(const std::string &command) const;
+
+    /**
+     * @param command the id of the command
+     * @return the number of variants of the command, including the command itself. 0 if the command is not available in this PoI
+     */
+    [[nodiscard]] int getVariantsNum(CommandId command) const;
+
+    /**
+     * @param command the id of the command
+     * @param variant the index of the variant, where 0 is the command itself and the others follow the order of their suffixes
+     * @return a pointer to the plan of the variant or nullptr if it does not exist
+     */
+    [[nodiscard]] const ActionPlan *getVariant(CommandId command, int variant) const;
+
+    /**
+     * @return the plans of all the commands and variants of the PoI
+     */
+    [[nodiscard]] const std::vector<ActionPlan> &getPlans() const;
+};
+
+/**
+ * The PoIs of the tour in one language, resolved when the model is built,
+ * so that switching language only swaps a pointer to another set.
+ */
+struct LanguageSet
+{
+    LanguageId language{INVALID_ID};
+    const PoIView *genericPoI{nullptr};
+    std::vector<const PoIView *> activePoIs; // Ordered as the active PoIs of the tour. nullptr if a PoI is missing in this language
+};
+
+/**
+ * Immutable, interned representation of a Tour.
+ * Languages, PoIs and commands are given integer ids at construction time and all the PoIs of
+ * all the languages are stored once. The parameters of the actions are deduplicated in a string pool. Consumers keep ids or const pointers into the model instead
+ * of copies of PoI objects.
+ */
+class TourModel
+{
+private:
+    StringPool m_strings; // The texts, dances and signals of all the plans, stored once
+    std::vector<std::string> m_languages;
+    std::unordered_map<std::string, LanguageId> m_languageIds;
+    std::vector<std::string> m_poiNames;
+    std::unordered_map<std::string, PoIId> m_poiIds;
+    std::vector<std::string> m_commandNames;
+    std::unordered_map<std::string, CommandId> m_commandIds;
+    std::vector<std::vector<PoIView>> m_pois; // Indexed as [LanguageId][PoIId]. Missing PoIs have an INVALID_ID id
+    std::vector<PoIId> m_activePoIs;
+    PoIId m_genericPoI{INVALID_ID};
+    std::vector<LanguageSet> m_languageSets; // Indexed by LanguageId
+
+    PoIId internPoI(const std::string &poiName);
+    CommandId internCommand(const std::string &command);
+    void buildView(PoIView &view, const PoI &poi, const MovementsContainer *movements);
+
+public:
+    static constexpr const char *GENERIC_POI_NAME = "___generic___";
+
+    /**
+     * Constructor
+     *
+     * @param tour the deserialized tour to intern
+     * @param movements the movements used to precompute the durations of the dances. If nullptr, the durations are 0
+     */
+    TourModel(const Tour &tour, const MovementsContainer *movements);
+
+    TourModel(const TourModel &) = delete;
+    TourModel &operator=(const TourModel &) = delete;
+    TourModel(TourModel &&) = delete;
+    TourModel &operator=(TourModel &&) = delete;
+
+    [[nodiscard]] LanguageId getLanguageId(const std::string &lang) const;
+    [[nodiscard]] const std::string &getLanguageName(LanguageId lang) const;
+    [[nodiscard]] const std::vector<std::string> &getAvailableLanguages() const;
+
+    [[nodiscard]] PoIId getPoIId(const std::string &poiName) const;
+    [[nodiscard]] const std::string &getPoIName(PoIId poi) const;
+
+    [[nodiscard]] CommandId getCommandId(const std::string &command) const;
+    [[nodiscard]] const std::string &getCommandName(CommandId command) const;
+    [[nodiscard]] const std::vector<std::string> &getCommandNames() const;
+
+    /**
+     * @return a pointer to the PoI in the given language or nullptr if it does not exist
+     */
+    [[nodiscard]] const PoIView *getPoI(LanguageId lang, PoIId poi) const;
+    [[nodiscard]] const PoIView *getPoI(LanguageId lang, const std::string &poiName) const;
+
+    /**
+     * @return a pointer to the index-th active PoI of the tour in the given language or nullptr if it does not exist
+     */
+    [[nodiscard]] const PoIView *getActivePoI(LanguageId lang, size_t index) const;
+    [[nodiscard]] const PoIView *getGenericPoI(LanguageId lang) const;
+
+    /**
+     * @return a pointer to the PoIs of the tour in the given language or nullptr if the language does not exist
+     */
+    [[nodiscard]] const LanguageSet *getLanguageSet(LanguageId lang) const;
+
+    /**
+     * @return the ordered list of the ids of the PoIs that are part of the tour
+     */
+    [[nodiscard]] const std::vector<PoIId> &getActivePoIs() const;
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_TOUR_MODEL_H
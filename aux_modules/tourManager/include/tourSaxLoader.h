@@ -0,0 +1,81 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_TOUR_SAX_LOADER_H
+#define BEHAVIOR_TOUR_ROBOT_TOUR_SAX_LOADER_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * SAX handler that extracts a single tour from the tours json file.
+ * All the other tours, and the languages that are not enabled, are only tokenized and never
+ * turned into json values. Parsing is stopped as soon as the selected tour has been read.
+ */
+class TourSaxLoader : public nlohmann::json_sax<nlohmann::ordered_json>
+{
+private:
+    enum class State
+    {
+        SEEKING,
+        RECORDING,
+        DONE
+    };
+
+    std::string m_tourName;
+    std::set<std::string> m_enabledLanguages; // If empty all the languages are loaded
+    State m_state{State::SEEKING};
+    int m_depth{0};                // Number of currently open objects and arrays
+    bool m_isSelectedKey{false};   // True if the last top level key is the selected tour
+    bool m_skipNextValue{false};   // True if the value following the last key has to be discarded
+    int m_skipDepth{-1};           // Depth at which the discarded container was opened, -1 if not skipping
+    std::string m_tourKey;         // Last key read at the tour level
+    std::string m_key;             // Last key read inside the selected tour
+    nlohmann::ordered_json m_tour;
+    std::vector<nlohmann::ordered_json *> m_stack;
+    std::string m_error;
+
+    bool isSkipping() const;
+    bool addValue(nlohmann::ordered_json &&value);
+    bool startContainer(nlohmann::ordered_json &&container);
+    bool endContainer();
+
+public:
+    /**
+     * Constructor
+     *
+     * @param tourName the name of the tour to extract
+     * @param enabledLanguages the languages to keep. If empty, all the languages of the tour are kept
+     */
+    TourSaxLoader(std::string tourName, const std::vector<std::string> &enabledLanguages);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t &s) override;
+    bool string(string_t &val) override;
+    bool binary(binary_t &val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t &val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string &last_token, const nlohmann::detail::exception &ex) override;
+
+    /**
+     * @return true if the selected tour has been completely read
+     */
+    [[nodiscard]] bool isComplete() const;
+
+    /**
+     * @return the last parse error, empty if none occurred
+     */
+    [[nodiscard]] const std::string &getError() const;
+
+    /**
+     * @return the json of the selected tour. Only valid if isComplete() is true
+     */
+    [[nodiscard]] nlohmann::ordered_json &getTour();
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_TOUR_SAX_LOADER_H
@@ -0,0 +1,81 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_TOUR_SNAPSHOT_H
+#define BEHAVIOR_TOUR_ROBOT_TOUR_SNAPSHOT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class Tour;
+class MovementsContainer;
+
+/**
+ * Precompiled binary snapshot of the tours and movements json files, written offline by the tourCompiler.
+ *
+ * Layout of the file:
+ *  - magic "TGRS" and format version (uint32, little endian)
+ *  - size of the index (uint32, little endian) followed by the MessagePack encoded index,
+ *    which maps every tour name and the movements to the [offset, size] of their blob in the file
+ *  - the MessagePack encoded blobs
+ *
+ * At startup the file is memory mapped and only the index, the selected tour and the movements are decoded,
+ * straight from the mapped MessagePack into the model objects.
+ */
+class TourSnapshot
+{
+private:
+    const std::uint8_t *m_data{nullptr};
+    size_t m_size{0};
+    size_t m_blobsOffset{0}; // Offset of the first blob in the file
+    nlohmann::json m_index;
+
+    bool GetBlob(const nlohmann::json &entry, const std::uint8_t *&outBegin, size_t &outSize) const;
+
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    TourSnapshot() = default;
+    ~TourSnapshot();
+
+    TourSnapshot(const TourSnapshot &) = delete;
+    TourSnapshot &operator=(const TourSnapshot &) = delete;
+
+    /**
+     * Memory maps a snapshot file and decodes its index
+     * @param path the path of the snapshot file
+     * @return true if the file is a valid snapshot
+     */
+    bool Open(const std::string &path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Decodes a single tour of the snapshot
+     * @param tourName the name of the tour
+     * @param languages the languages to keep. If empty, all the languages of the tour are kept
+     * @param outTour the decoded tour
+     * @return true if the tour is in the snapshot and is valid
+     */
+    bool ReadTour(const std::string &tourName, const std::vector<std::string> &languages, Tour &outTour) const;
+
+    /**
+     * Decodes the movements of the snapshot
+     * @param outMovements the decoded movements
+     * @param outDurations the precomputed duration of every dance, empty if the snapshot has none
+     * @return true if the movements are in the snapshot and are valid
+     */
+    bool ReadMovements(MovementsContainer &outMovements, std::map<std::string, float> &outDurations) const;
+
+    /**
+     * Writes a snapshot file
+     * @param path the path of the file to write
+     * @param tours the content of the tours json file
+     * @param movements the content of the movements json file
+     * @param durations the precomputed duration of every dance
+     * @return true if the file has been written
+     */
+    static bool Write(const std::string &path, const nlohmann::ordered_json &tours, const nlohmann::ordered_json &movements, const std::map<std::string, float> &durations);
+};
+
+#endif // BEHAVIOR_TOUR_ROBOT_TOUR_SNAPSHOT_H
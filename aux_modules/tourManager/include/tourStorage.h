@@ -2,12 +2,18 @@
 #ifndef BEHAVIOR_TOUR_ROBOT_TOUR_STORAGE_H
 #define BEHAVIOR_TOUR_ROBOT_TOUR_STORAGE_H
 
+#include "movementStorage.h"
 #include "poi.h"
+#include "rcuPointer.h"
 #include "tour.h"
+#include "tourModel.h"
+#include "tourSaxLoader.h"
+#include "tourSnapshot.h"
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
 
 class TourStorage
@@ -16,9 +22,17 @@ private:
     TourStorage() {}
     ~TourStorage() {}
 
-    Tour m_loadedTour; // The Tour object that was loaded
+    RcuPointer<TourModel> m_tourModel; // The interned model of the Tour object that was loaded, swapped atomically on reload
+
+    std::unique_ptr<const TourModel> BuildModel(const nlohmann::ordered_json &tourJson, const std::string &tourName, const MovementsContainer *movements);
+    std::unique_ptr<const TourModel> BuildModel(const Tour &tour, const std::string &tourName, const MovementsContainer *movements);
+
 public:
-    static TourStorage &GetInstance(const std::string &pathJSONTours, const std::string &tourName);
+    using ModelGuard = RcuPointer<TourModel>::ReadGuard;
+
+    static TourStorage &GetInstance();
+    static TourStorage &GetInstance(const std::string &pathJSONTours, const std::string &tourName, const std::vector<std::string> &languages = {});
+    static TourStorage &GetInstance(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages = {});
 
     TourStorage(const TourStorage &) = delete;
     TourStorage &operator=(const TourStorage &) = delete;
@@ -27,8 +41,28 @@ public:
 
     nlohmann::ordered_json ReadFileAsJSON(const std::string &path);
     bool WriteJSONtoFile(const nlohmann::ordered_json &j, const std::string &path);
-    bool LoadTour(const std::string &pathTours, const std::string &tourName);
-    Tour &GetTour();
+    bool LoadTour(const std::string &pathTours, const std::string &tourName, const std::vector<std::string> &languages = {});
+    bool LoadTour(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages = {});
+
+    /**
+     * Builds the model of a tour without publishing it, so that it can be published together with new movements
+     * @param movements the movements the dance durations of the model are taken from
+     * @return the model, nullptr if the tour cannot be read or is not valid
+     */
+    std::unique_ptr<const TourModel> BuildTour(const std::string &pathTours, const std::string &tourName, const std::vector<std::string> &languages, const MovementsContainer *movements);
+    std::unique_ptr<const TourModel> BuildTour(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages, const MovementsContainer *movements);
+
+    /**
+     * Publishes a model built by BuildTour. Readers that pinned the previous model keep using it until they release it
+     */
+    void Publish(std::unique_ptr<const TourModel> model, const std::string &tourName);
+
+    /**
+     * Pins the currently loaded tour model. Never blocks, even while a new tour is being loaded.
+     * The model stays valid as long as the returned guard is alive.
+     * @return the guard of the model, empty if no tour was loaded
+     */
+    ModelGuard GetTourModel() const;
 };
 
 #endif // BEHAVIOR_TOUR_ROBOT_TOUR_STORAGE_H
@@ -0,0 +1,133 @@
+#include "actionPlan.h"
+#include "movementStorage.h"
+
+YARP_LOG_COMPONENT(ACTION_PLAN, "behavior_tour_robot.aux_modules.TourManager.ActionPlan", yarp::os::Log::TraceType)
+
+namespace
+{
+    constexpr const char *SET_LANGUAGE_PREFIX = "setLanguage_";
+    constexpr const char *DELAY_PREFIX = "delay_";
+
+    bool StartsWith(std::string_view text, std::string_view prefix)
+    {
+        return text.substr(0, prefix.size()) == prefix;
+    }
+}
+
+SignalCommand SignalCommand::Parse(std::string_view param)
+{
+    SignalCommand signal;
+    if (param == "startHearing")
+    {
+        signal.type = SignalTypes::START_HEARING;
+    }
+    else if (param == "nextPoi")
+    {
+        signal.type = SignalTypes::NEXT_POI;
+    }
+    else if (param == "reset")
+    {
+        signal.type = SignalTypes::RESET;
+    }
+    else if (StartsWith(param, SET_LANGUAGE_PREFIX))
+    {
+        signal.voice = param.substr(std::string_view(SET_LANGUAGE_PREFIX).size());
+        signal.language = signal.voice.substr(0, signal.voice.find("-", 4)); // The language is the part of the voice before the second delimiter
+        if (!signal.voice.empty() && !signal.language.empty())
+        {
+            signal.type = SignalTypes::SET_LANGUAGE;
+        }
+    }
+    else if (StartsWith(param, DELAY_PREFIX))
+    {
+        std::string value(param.substr(std::string_view(DELAY_PREFIX).size()));
+        try
+        {
+            size_t parsed = 0;
+            signal.delay = std::stof(value, &parsed);
+            if (parsed == value.size() && signal.delay >= 0.0f)
+            {
+                signal.type = SignalTypes::DELAY;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+    }
+    return signal;
+}
+
+ActionPlan::ActionPlan(const std::vector<Action> &actions, const MovementsContainer *movements, StringPool &strings)
+{
+    m_steps.reserve(actions.size());
+    int lastNonSignal = -1;
+    int groupBegin = 0;
+
+    for (int i = 0; i < static_cast<int>(actions.size()); i++)
+    {
+        const Action &action = actions[i];
+        PlanStep step;
+        step.type = action.getType();
+        switch (step.type)
+        {
+        case ActionTypes::SPEAK:
+            step.param = strings.Intern(action.getParam());
+            break;
+        case ActionTypes::DANCE:
+        {
+            step.param = strings.Intern(action.getParam());
+            const Dance *dance = movements ? movements->FindDance(action.getParam()) : nullptr;
+            if (dance)
+            {
+                step.danceDuration = dance->GetDuration();
+            }
+            else if (movements)
+            {
+                yCWarning(ACTION_PLAN) << "Dance" << step.param << "not found. It will be skipped.";
+            }
+            break;
+        }
+        case ActionTypes::SIGNAL:
+            step.signal = SignalCommand::Parse(strings.Intern(action.getParam()));
+            if (step.signal.type == SignalTypes::INVALID)
+            {
+                yCWarning(ACTION_PLAN) << "Signal" << action.getParam() << "is not valid. It will be skipped.";
+            }
+            break;
+        default:
+            break;
+        }
+        m_steps.push_back(std::move(step));
+
+        if (action.getType() != ActionTypes::SIGNAL)
+        {
+            lastNonSignal = i;
+        }
+        bool isLast = i == static_cast<int>(actions.size()) - 1;
+        if (action.isBlocking() || isLast)
+        {
+            PlanGroup group{groupBegin, i + 1, true};
+            if (!action.isBlocking() && lastNonSignal >= 0 && !actions[lastNonSignal].isBlocking())
+            {
+                group.isWaited = false; // The command ends with non blocking actions, nobody waits for them
+            }
+            m_groups.push_back(group);
+            groupBegin = i + 1;
+        }
+    }
+}
+
+const std::vector<PlanStep> &ActionPlan::getSteps() const
+{
+    return m_steps;
+}
+
+const std::vector<PlanGroup> &ActionPlan::getGroups() const
+{
+    return m_groups;
+}
+
+bool ActionPlan::empty() const
+{
+    return m_steps.empty();
+}
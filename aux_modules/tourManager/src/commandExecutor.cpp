@@ -0,0 +1,153 @@
+#include <commandExecutor.h>
+#include <yarp/os/LogStream.h>
+
+YARP_LOG_COMPONENT(COMMAND_EXECUTOR, "behavior_tour_robot.aux_modules.TourManager.CommandExecutor", yarp::os::Log::TraceType)
+
+CancellationToken CancellationToken::Create()
+{
+    CancellationToken token;
+    token.m_isCancelled = std::make_shared<std::atomic<bool>>(false);
+    return token;
+}
+
+void CancellationToken::Cancel() const
+{
+    if (m_isCancelled)
+    {
+        *m_isCancelled = true;
+    }
+}
+
+bool CancellationToken::IsCancelled() const
+{
+    return m_isCancelled && *m_isCancelled;
+}
+
+bool CancellationToken::IsSameAs(const CancellationToken &other) const
+{
+    return m_isCancelled && m_isCancelled == other.m_isCancelled;
+}
+
+CommandExecutor::CommandExecutor(Handler handler) : m_handler(std::move(handler))
+{
+}
+
+CommandExecutor::~CommandExecutor()
+{
+    Stop();
+}
+
+void CommandExecutor::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isRunning)
+    {
+        return;
+    }
+    m_isRunning = true;
+    m_thread = std::thread([this]
+                           { Run(); });
+}
+
+void CommandExecutor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+        m_runningToken.Cancel();
+        for (const Item &item : m_queue)
+        {
+            item.result->set_value(false);
+        }
+        m_queue.clear();
+    }
+    m_hasItems.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+std::shared_future<bool> CommandExecutor::Post(const std::string &command, CommandPriority priority, bool isCoalesced)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Item &item : m_queue)
+    {
+        if (isCoalesced && item.command == command && item.priority == priority)
+        {
+            yCDebug(COMMAND_EXECUTOR) << "Command" << command << "is already queued. Skipping the duplicate.";
+            return item.future;
+        }
+    }
+
+    Item item{command, priority, m_nextSequence++, std::make_shared<std::promise<bool>>(), {}};
+    item.future = item.result->get_future().share();
+    if (!m_isRunning)
+    {
+        item.result->set_value(false);
+        return item.future;
+    }
+
+    if (m_isBusy && priority > m_runningPriority)
+    {
+        yCDebug(COMMAND_EXECUTOR) << "Command" << command << "preempts the running command.";
+        m_runningToken.Cancel();
+    }
+    std::shared_future<bool> future = item.future;
+    m_queue.insert(std::move(item));
+    m_hasItems.notify_one();
+    return future;
+}
+
+bool CommandExecutor::Execute(const std::string &command, CommandPriority priority)
+{
+    if (std::this_thread::get_id() == m_thread.get_id())
+    { // Nested command, e.g. from a signal. Waiting for the queue would never end
+        CancellationToken token;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            token = m_runningToken;
+        }
+        return m_handler(command, token);
+    }
+    return Post(command, priority).get();
+}
+
+void CommandExecutor::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_hasItems.wait(lock, [this]
+                        { return !m_isRunning || !m_queue.empty(); });
+        if (!m_isRunning)
+        {
+            return;
+        }
+        Item item = *m_queue.begin();
+        m_queue.erase(m_queue.begin());
+        m_isBusy = true;
+        m_runningPriority = item.priority;
+        m_runningToken = CancellationToken::Create();
+        CancellationToken token = m_runningToken;
+        lock.unlock();
+
+        bool result = false;
+        try
+        {
+            result = m_handler(item.command, token);
+        }
+        catch (const std::exception &e)
+        {
+            yCError(COMMAND_EXECUTOR) << "Command" << item.command << "failed with an exception:" << e.what();
+        }
+        if (token.IsCancelled())
+        {
+            yCDebug(COMMAND_EXECUTOR) << "Command" << item.command << "has been cancelled.";
+        }
+        item.result->set_value(result);
+
+        lock.lock();
+        m_isBusy = false;
+    }
+}
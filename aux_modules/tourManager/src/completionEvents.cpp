@@ -0,0 +1,211 @@
+#include <completionEvents.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+#include <algorithm>
+#include <chrono>
+
+YARP_LOG_COMPONENT(COMPLETION_EVENTS, "behavior_tour_robot.aux_modules.TourManager.CompletionEvents", yarp::os::Log::TraceType)
+
+/**
+ *
+ * START OF COMPLETION_EVENTS
+ *
+ */
+
+void CompletionEvents::SetSpeaking(bool isSpeaking)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isSpeaking = isSpeaking;
+    m_changed.notify_all();
+}
+
+void CompletionEvents::OnSpeechEvent(bool isSpeaking)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasSpeechEvents = true;
+    m_isSpeaking = isSpeaking;
+    if (isSpeaking && !m_isSpeakingNotified)
+    {
+        m_speechStartTime = yarp::os::Time::now();
+    }
+    m_isSpeakingNotified = isSpeaking;
+    m_changed.notify_all();
+}
+
+void CompletionEvents::OnUtteranceEvent(const std::string &event, std::int64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasUtteranceEvents = true;
+    if ((event == "finished" || event == "reset") && id > m_doneUtterance) // The utterances are done in order
+    {
+        m_doneUtterance = id;
+        m_changed.notify_all();
+    }
+}
+
+bool CompletionEvents::IsSpeaking()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isSpeaking;
+}
+
+bool CompletionEvents::HasSpeechEvents()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hasSpeechEvents;
+}
+
+bool CompletionEvents::HasUtteranceEvents()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hasUtteranceEvents;
+}
+
+double CompletionEvents::GetSpeechStartTime()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_speechStartTime;
+}
+
+bool CompletionEvents::WaitSpeechIdle(double timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_changed.wait_for(lock, std::chrono::duration<double>(timeout), [this]
+                              { return !m_isSpeaking; });
+}
+
+bool CompletionEvents::WaitUtterance(std::int64_t id, double timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_changed.wait_for(lock, std::chrono::duration<double>(timeout), [this, id]
+                              { return id <= m_doneUtterance; });
+}
+
+void CompletionEvents::SetNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum status)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_navigationStatus != status)
+    {
+        m_navigationStatus = status;
+        m_changed.notify_all();
+    }
+}
+
+yarp::dev::Nav2D::NavigationStatusEnum CompletionEvents::GetNavigationStatus()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_navigationStatus;
+}
+
+bool CompletionEvents::WaitNavigationStatus(std::initializer_list<yarp::dev::Nav2D::NavigationStatusEnum> statuses, double timeout, yarp::dev::Nav2D::NavigationStatusEnum &outStatus)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto isAccepted = [this, &statuses]
+    { return std::find(statuses.begin(), statuses.end(), m_navigationStatus) != statuses.end(); };
+
+    bool result = true;
+    if (timeout < 0.0)
+    {
+        m_changed.wait(lock, isAccepted);
+    }
+    else
+    {
+        result = m_changed.wait_for(lock, std::chrono::duration<double>(timeout), isAccepted);
+    }
+    outStatus = m_navigationStatus;
+    return result;
+}
+
+/**
+ *
+ * END OF COMPLETION_EVENTS
+ *
+ */
+
+SpeechStatusCallback::SpeechStatusCallback(CompletionEvents &events) : m_events(events)
+{
+}
+
+void SpeechStatusCallback::onRead(yarp::os::Bottle &b)
+{
+    std::string status = b.get(0).asString();
+    if (status == "speaking" || status == "idle")
+    {
+        m_events.OnSpeechEvent(status == "speaking");
+    }
+    else
+    {
+        yCWarning(COMPLETION_EVENTS) << "Unknown speech status received:" << status;
+    }
+}
+
+SpeechEventsCallback::SpeechEventsCallback(CompletionEvents &events) : m_events(events)
+{
+}
+
+void SpeechEventsCallback::onRead(yarp::os::Bottle &b)
+{
+    if (b.size() < 2 || !b.get(0).isString())
+    {
+        yCWarning(COMPLETION_EVENTS) << "Malformed speech event received:" << b.toString();
+        return;
+    }
+    m_events.OnUtteranceEvent(b.get(0).asString(), b.get(1).asInt64());
+}
+
+NavigationMonitor::NavigationMonitor(CompletionEvents &events, double period) : yarp::os::PeriodicThread(period),
+                                                                                m_events(events)
+{
+}
+
+void NavigationMonitor::SetNavigation(NavigationInterface *navigation)
+{
+    m_navigation = navigation;
+}
+
+void NavigationMonitor::Activate()
+{
+    std::lock_guard<std::mutex> lock(m_activeMutex);
+    if (m_activeScopes++ == 0)
+    {
+        run(); // The waits start from the current status, not from the one left by the previous navigation
+        resume();
+    }
+}
+
+void NavigationMonitor::Deactivate()
+{
+    std::lock_guard<std::mutex> lock(m_activeMutex);
+    if (--m_activeScopes == 0)
+    {
+        suspend();
+    }
+}
+
+void NavigationMonitor::Refresh()
+{
+    std::lock_guard<std::mutex> lock(m_activeMutex);
+    if (m_activeScopes == 0)
+    {
+        run();
+    }
+}
+
+NavigationMonitor::ActiveScope::ActiveScope(NavigationMonitor &monitor) : m_monitor(monitor)
+{
+    m_monitor.Activate();
+}
+
+NavigationMonitor::ActiveScope::~ActiveScope()
+{
+    m_monitor.Deactivate();
+}
+
+void NavigationMonitor::run()
+{
+    yarp::dev::Nav2D::NavigationStatusEnum status;
+    if (m_navigation && m_navigation->getNavigationStatus(status))
+    {
+        m_events.SetNavigationStatus(status);
+    }
+}
@@ -0,0 +1,171 @@
+#include <contentReloader.h>
+#include <yarp/os/LogStream.h>
+#include <chrono>
+#include <sys/stat.h>
+
+YARP_LOG_COMPONENT(CONTENT_RELOADER, "behavior_tour_robot.aux_modules.TourManager.ContentReloader", yarp::os::Log::TraceType)
+
+namespace
+{
+    timespec GetModificationTime(const std::string &path)
+    {
+        struct stat fileStat;
+        if (path.empty() || ::stat(path.c_str(), &fileStat) != 0)
+        {
+            return {};
+        }
+        return fileStat.st_mtim;
+    }
+
+    bool IsSameTime(const timespec &a, const timespec &b)
+    {
+        return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+    }
+
+    bool IsOlder(const timespec &a, const timespec &b)
+    {
+        return a.tv_sec < b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec < b.tv_nsec);
+    }
+}
+
+ContentReloader::ContentReloader(const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &pathSnapshot, const std::string &tourName, const std::vector<std::string> &languages) : yarp::os::PeriodicThread(1.0),
+                                                                                                                                                                                                              m_pathJSONTours(pathJSONTours),
+                                                                                                                                                                                                              m_pathJSONMovements(pathJSONMovements),
+                                                                                                                                                                                                              m_pathSnapshot(pathSnapshot),
+                                                                                                                                                                                                              m_tourName(tourName),
+                                                                                                                                                                                                              m_languages(languages),
+                                                                                                                                                                                                              m_watchFiles(true)
+{
+}
+
+bool ContentReloader::Load()
+{
+    UpdateFileTimes();
+    if (IsSnapshotFresh()) // Prefer the precompiled snapshot, if available and not stale
+    {
+        if (LoadFromSnapshot())
+        {
+            yCInfo(CONTENT_RELOADER) << "Loaded the content from the snapshot" << m_pathSnapshot;
+            return true;
+        }
+        yCWarning(CONTENT_RELOADER) << "Snapshot" << m_pathSnapshot << "not usable. Loading the json files instead.";
+    }
+    else if (!m_pathSnapshot.empty())
+    {
+        yCWarning(CONTENT_RELOADER) << "Snapshot" << m_pathSnapshot << "is older than the json files. Loading the json files instead.";
+    }
+    if (!LoadFromJSON())
+    {
+        return false;
+    }
+    yCInfo(CONTENT_RELOADER) << "Loaded the content from the json files" << m_pathJSONTours << "and" << m_pathJSONMovements;
+    return true;
+}
+
+bool ContentReloader::IsSnapshotFresh() const
+{
+    // The snapshot is stale once the json files have been edited after it was compiled
+    return !m_pathSnapshot.empty() && !IsOlder(m_snapshotTime, m_toursTime) && !IsOlder(m_snapshotTime, m_movementsTime);
+}
+
+bool ContentReloader::LoadFromSnapshot()
+{
+    TourSnapshot snapshot;
+    if (m_pathSnapshot.empty() || !snapshot.Open(m_pathSnapshot))
+    {
+        return false;
+    }
+    std::unique_ptr<MovementsContainer> movements = MovementStorage::GetInstance().BuildMovements(snapshot);
+    if (!movements)
+    {
+        return false;
+    }
+    std::unique_ptr<const TourModel> tour = TourStorage::GetInstance().BuildTour(snapshot, m_tourName, m_languages, movements.get());
+    return Publish(std::move(movements), std::move(tour));
+}
+
+bool ContentReloader::LoadFromJSON()
+{
+    std::unique_ptr<MovementsContainer> movements = MovementStorage::GetInstance().BuildMovements(m_pathJSONMovements);
+    if (!movements)
+    {
+        return false;
+    }
+    std::unique_ptr<const TourModel> tour = TourStorage::GetInstance().BuildTour(m_pathJSONTours, m_tourName, m_languages, movements.get());
+    return Publish(std::move(movements), std::move(tour));
+}
+
+bool ContentReloader::Publish(std::unique_ptr<MovementsContainer> movements, std::unique_ptr<const TourModel> tour)
+{
+    if (!tour)
+    {
+        return false; // Nothing is published, the previous tour and movements are still used together
+    }
+    // The movements are published first, so that the new tour never refers to dances that are not loaded yet
+    MovementStorage::GetInstance().Publish(std::move(movements));
+    TourStorage::GetInstance().Publish(std::move(tour), m_tourName);
+    return true;
+}
+
+bool ContentReloader::UpdateFileTimes()
+{
+    timespec toursTime = GetModificationTime(m_pathJSONTours);
+    timespec movementsTime = GetModificationTime(m_pathJSONMovements);
+    timespec snapshotTime = GetModificationTime(m_pathSnapshot);
+    bool changed = !IsSameTime(toursTime, m_toursTime) || !IsSameTime(movementsTime, m_movementsTime) || !IsSameTime(snapshotTime, m_snapshotTime);
+    m_toursTime = toursTime;
+    m_movementsTime = movementsTime;
+    m_snapshotTime = snapshotTime;
+    return changed;
+}
+
+bool ContentReloader::Reload(double timeout)
+{
+    std::unique_lock<std::mutex> lock(m_requestMutex);
+    unsigned ticket = ++m_requested;
+    if (!m_requestDone.wait_for(lock, std::chrono::duration<double>(timeout), [this, ticket]
+                                { return m_served >= ticket; }))
+    {
+        yCError(CONTENT_RELOADER) << "Reload timed out. Is the content reloader running?";
+        return false;
+    }
+    return m_lastResult;
+}
+
+void ContentReloader::SetWatch(bool watchFiles, double period)
+{
+    m_watchFiles = watchFiles;
+    setPeriod(period);
+}
+
+void ContentReloader::run()
+{
+    unsigned requested;
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        requested = m_requested;
+    }
+    bool isRequested = requested != m_served;
+    bool isModified = m_watchFiles && UpdateFileTimes();
+    if (!isRequested && !isModified)
+    {
+        return;
+    }
+    if (isRequested)
+    {
+        UpdateFileTimes(); // The files are reloaded now, so their current version must not trigger another reload
+    }
+
+    bool isSnapshotFresh = IsSnapshotFresh();
+    yCInfo(CONTENT_RELOADER) << "Reloading the content from the" << (isSnapshotFresh ? "snapshot" : "json files");
+    bool result = (isSnapshotFresh && LoadFromSnapshot()) || LoadFromJSON();
+    if (!result)
+    {
+        yCError(CONTENT_RELOADER) << "Reload failed. The previous content is still in use.";
+    }
+
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    m_lastResult = result;
+    m_served = requested;
+    m_requestDone.notify_all();
+}
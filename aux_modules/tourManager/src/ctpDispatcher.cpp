@@ -0,0 +1,161 @@
+#include <ctpDispatcher.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+#include <algorithm>
+
+YARP_LOG_COMPONENT(CTP_DISPATCHER, "behavior_tour_robot.aux_modules.TourManager.CtpDispatcher", yarp::os::Log::TraceType)
+
+CtpDispatcher::Batch::Batch(std::string name) : m_name(std::move(name))
+{
+}
+
+CtpDispatcher::~CtpDispatcher()
+{
+    Stop();
+}
+
+void CtpDispatcher::AddPart(const std::string &part, yarp::os::Port &port)
+{
+    std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+    worker->part = part;
+    worker->port = &port;
+    Worker &runningWorker = *worker;
+    worker->thread = std::thread([this, &runningWorker]
+                                 { Run(runningWorker); });
+    m_workers[part] = std::move(worker);
+}
+
+void CtpDispatcher::Stop()
+{
+    for (auto &worker : m_workers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker.second->mutex);
+            worker.second->isStopping = true;
+            worker.second->jobs.clear();
+        }
+        worker.second->hasJobs.notify_all();
+    }
+    for (auto &worker : m_workers)
+    {
+        if (worker.second->thread.joinable())
+        {
+            worker.second->thread.join();
+        }
+    }
+    m_workers.clear();
+}
+
+bool CtpDispatcher::HasPart(const std::string &part) const
+{
+    return m_workers.count(part) > 0;
+}
+
+bool CtpDispatcher::Dispatch(const std::string &part, const std::shared_ptr<const yarp::os::Bottle> &command, const std::shared_ptr<Batch> &batch)
+{
+    auto found = m_workers.find(part);
+    if (found == m_workers.end())
+    {
+        return false;
+    }
+    Worker &worker = *found->second;
+
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    Job job{command, batch, worker.lastBatch != batch};
+    if (job.isFirst)
+    {
+        std::lock_guard<std::mutex> batchLock(batch->m_mutex);
+        batch->m_pendingParts++;
+        worker.lastBatch = batch;
+    }
+    worker.jobs.push_back(std::move(job));
+    worker.hasJobs.notify_one();
+    return true;
+}
+
+void CtpDispatcher::Seal(const std::shared_ptr<Batch> &batch)
+{
+    {
+        std::lock_guard<std::mutex> lock(batch->m_mutex);
+        batch->m_isSealed = true;
+    }
+    ReportIfComplete(*batch);
+}
+
+void CtpDispatcher::Run(Worker &worker)
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.hasJobs.wait(lock, [&worker]
+                                { return worker.isStopping || !worker.jobs.empty(); });
+            if (worker.isStopping)
+            {
+                return;
+            }
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+        }
+
+        yarp::os::Bottle res;
+        if (!worker.port->write(*job.command, res)) // Blocks until the ctpService of this part accepts the movement
+        {
+            yCError(CTP_DISPATCHER) << "Movement failed to sent. Is ctpService for part" << worker.part << "running?";
+        }
+        if (job.isFirst)
+        {
+            OnFirstMovement(*job.batch, yarp::os::Time::now());
+        }
+    }
+}
+
+void CtpDispatcher::OnFirstMovement(Batch &batch, double time)
+{
+    {
+        std::lock_guard<std::mutex> lock(batch.m_mutex);
+        batch.m_pendingParts--;
+        if (batch.m_startedParts == 0)
+        {
+            batch.m_firstStart = time;
+        }
+        batch.m_lastStart = std::max(batch.m_lastStart, time);
+        batch.m_startedParts++;
+    }
+    ReportIfComplete(batch);
+}
+
+void CtpDispatcher::ReportIfComplete(Batch &batch)
+{
+    double skew;
+    int partsNum;
+    {
+        std::lock_guard<std::mutex> lock(batch.m_mutex);
+        if (!batch.m_isSealed || batch.m_pendingParts > 0 || batch.m_startedParts == 0)
+        {
+            return;
+        }
+        skew = batch.m_lastStart - batch.m_firstStart;
+        partsNum = batch.m_startedParts;
+        batch.m_startedParts = 0; // Reported only once
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_statisticsMutex);
+        m_batchesNum++;
+        m_skewSum += skew;
+        m_skewMax = std::max(m_skewMax, skew);
+    }
+    yCDebug(CTP_DISPATCHER) << "Dance" << batch.m_name << "started on" << partsNum << "parts with a start skew of" << skew * 1000.0 << "ms";
+}
+
+void CtpDispatcher::LogStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    if (m_batchesNum == 0)
+    {
+        return;
+    }
+    yCInfo(CTP_DISPATCHER) << "Dispatched" << m_batchesNum << "dances. Start skew between the parts: average" << m_skewSum / m_batchesNum * 1000.0 << "ms, max" << m_skewMax * 1000.0 << "ms";
+}
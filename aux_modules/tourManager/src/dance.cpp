@@ -10,10 +10,10 @@ void Dance::UpdateDuration()
 {
     std::map<std::string, float> durationPerPart;
 
-    for (Movement movement : m_movements)
+    for (const Movement &movement : m_movements)
     { // For each of the movements in the dance
         float moveTime = movement.GetTime();
-        std::string partName = movement.GetPartName();
+        const std::string &partName = movement.GetPartName();
 
         if (moveTime != 0.0f)
         {
@@ -38,12 +38,25 @@ void Dance::UpdateDuration()
     m_duration = longestPartMoveTime;
 }
 
+void Dance::SetDuration(float duration)
+{
+    m_duration = duration;
+}
+
 float Dance::GetDuration() const
 {
     return m_duration;
 }
 
-std::vector<Movement> Dance::GetMovements() const
+const std::vector<Movement> &Dance::GetMovements() const
 {
     return m_movements;
 }
+
+void Dance::BuildCommands()
+{
+    for (Movement &movement : m_movements)
+    {
+        movement.BuildCommand();
+    }
+}
@@ -0,0 +1,176 @@
+#include <jobPool.h>
+#include <yarp/os/LogStream.h>
+#include <algorithm>
+
+YARP_LOG_COMPONENT(JOB_POOL, "behavior_tour_robot.aux_modules.TourManager.JobPool", yarp::os::Log::TraceType)
+
+JobPool::~JobPool()
+{
+    Stop();
+}
+
+void JobPool::Start(int workersNum)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isRunning)
+    {
+        return;
+    }
+    m_isRunning = true;
+    for (int i = 0; i < std::max(workersNum, 1); i++)
+    {
+        m_workers.emplace_back([this]
+                               { Run(); });
+    }
+}
+
+void JobPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+        for (auto &job : m_queue)
+        {
+            End(*job, JobStatus::CANCELLED);
+        }
+        m_queue.clear();
+        for (auto &job : m_jobs)
+        {
+            job.second->token.Cancel();
+        }
+    }
+    m_hasJobs.notify_all();
+    for (std::thread &worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+JobPool::JobId JobPool::Submit(const std::string &name, Task task)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isRunning)
+    {
+        yCError(JOB_POOL) << "Cannot start the job" << name << ": the pool is not running";
+        return -1;
+    }
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->id = m_nextId++;
+    job->name = name;
+    job->task = std::move(task);
+    m_jobs[job->id] = job;
+    m_queue.push_back(job);
+    m_hasJobs.notify_one();
+    yCDebug(JOB_POOL) << "Queued job" << job->id << ":" << name;
+    return job->id;
+}
+
+JobStatus JobPool::GetStatus(JobId id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_jobs.find(id);
+    return found != m_jobs.end() ? found->second->status : JobStatus::UNKNOWN;
+}
+
+bool JobPool::Cancel(JobId id, CancellationToken *outToken)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_jobs.find(id);
+    if (found == m_jobs.end())
+    {
+        return false;
+    }
+    Job &job = *found->second;
+    if (job.status == JobStatus::PENDING)
+    {
+        for (auto queued = m_queue.begin(); queued != m_queue.end(); ++queued)
+        {
+            if ((*queued)->id == id)
+            {
+                m_queue.erase(queued);
+                break;
+            }
+        }
+        End(job, JobStatus::CANCELLED);
+        return true;
+    }
+    if (job.status == JobStatus::RUNNING)
+    {
+        job.token.Cancel();
+        if (outToken)
+        {
+            *outToken = job.token;
+        }
+        return true;
+    }
+    return false;
+}
+
+std::string JobPool::ToString(JobStatus status)
+{
+    switch (status)
+    {
+    case JobStatus::PENDING:
+        return "pending";
+    case JobStatus::RUNNING:
+        return "running";
+    case JobStatus::SUCCEEDED:
+        return "succeeded";
+    case JobStatus::FAILED:
+        return "failed";
+    case JobStatus::CANCELLED:
+        return "cancelled";
+    default:
+        return "unknown";
+    }
+}
+
+void JobPool::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_hasJobs.wait(lock, [this]
+                       { return !m_isRunning || !m_queue.empty(); });
+        if (m_queue.empty())
+        {
+            return; // Stopped
+        }
+        std::shared_ptr<Job> job = std::move(m_queue.front());
+        m_queue.pop_front();
+        job->status = JobStatus::RUNNING;
+        lock.unlock();
+
+        bool result = false;
+        try
+        {
+            result = job->task(job->token);
+        }
+        catch (const std::exception &e)
+        {
+            yCError(JOB_POOL) << "Job" << job->id << ":" << job->name << "failed with an exception:" << e.what();
+        }
+
+        lock.lock();
+        JobStatus status = result ? JobStatus::SUCCEEDED : JobStatus::FAILED;
+        End(*job, job->token.IsCancelled() ? JobStatus::CANCELLED : status);
+    }
+}
+
+void JobPool::End(Job &job, JobStatus status)
+{
+    job.status = status;
+    job.task = nullptr;
+    yCDebug(JOB_POOL) << "Job" << job.id << ":" << job.name << "ended:" << ToString(status);
+
+    m_endedJobs.push_back(job.id);
+    if (m_endedJobs.size() > MAX_ENDED_JOBS)
+    {
+        m_jobs.erase(m_endedJobs.front());
+        m_endedJobs.pop_front();
+    }
+}
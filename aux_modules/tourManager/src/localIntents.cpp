@@ -0,0 +1,244 @@
+#include <localIntents.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+YARP_LOG_COMPONENT(LOCAL_INTENTS, "behavior_tour_robot.aux_modules.TourManager.LocalIntents", yarp::os::Log::TraceType)
+
+/**
+ *
+ * START OF INTENT_INDEX
+ *
+ */
+
+IntentIndex::IntentIndex(const std::vector<Intent> &intents) : m_intents(intents)
+{
+    for (size_t intent = 0; intent < m_intents.size(); intent++)
+    {
+        for (const std::string &phrase : m_intents[intent].phrases)
+        {
+            int phraseId = static_cast<int>(m_phraseIntents.size());
+            std::vector<std::uint32_t> trigrams = Trigrams(Normalize(phrase));
+            m_phraseIntents.push_back(static_cast<int>(intent));
+            m_phraseTrigramsNum.push_back(static_cast<int>(trigrams.size()));
+            for (std::uint32_t trigram : trigrams)
+            {
+                m_postings[trigram].push_back(phraseId);
+            }
+        }
+    }
+}
+
+std::string IntentIndex::Normalize(const std::string &text)
+{
+    std::string normalized;
+    normalized.reserve(text.size());
+    bool isSpace = true; // Skips the leading spaces
+    for (unsigned char c : text)
+    {
+        if (c >= 0x80 || std::isalnum(c)) // The bytes of the non ascii letters are kept as they are
+        {
+            normalized.push_back(static_cast<char>(std::tolower(c)));
+            isSpace = false;
+        }
+        else if (!isSpace)
+        {
+            normalized.push_back(' ');
+            isSpace = true;
+        }
+    }
+    if (!normalized.empty() && normalized.back() == ' ')
+    {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+std::vector<std::uint32_t> IntentIndex::Trigrams(const std::string &text)
+{
+    std::string padded = " " + text + " "; // The first and last letters of the text get their own trigrams
+    std::vector<std::uint32_t> trigrams;
+    for (size_t i = 0; i + 3 <= padded.size(); i++)
+    {
+        trigrams.push_back(static_cast<std::uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+                           static_cast<std::uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8 |
+                           static_cast<std::uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+IntentIndex::Match IntentIndex::Find(const std::string &text, const std::string &poiName) const
+{
+    std::vector<std::uint32_t> trigrams = Trigrams(Normalize(text));
+    std::vector<int> shared(m_phraseIntents.size(), 0);
+    for (std::uint32_t trigram : trigrams)
+    {
+        auto posting = m_postings.find(trigram);
+        if (posting != m_postings.end())
+        {
+            for (int phrase : posting->second)
+            {
+                shared[phrase]++;
+            }
+        }
+    }
+
+    Match match;
+    int bestIntent = -1;
+    for (size_t phrase = 0; phrase < shared.size(); phrase++)
+    {
+        const Intent &intent = m_intents[m_phraseIntents[phrase]];
+        if (shared[phrase] == 0 || (!intent.isGeneric && !intent.pois.count(poiName)))
+        {
+            continue;
+        }
+        double score = 2.0 * shared[phrase] / (trigrams.size() + m_phraseTrigramsNum[phrase]);
+        if (m_phraseIntents[phrase] == bestIntent)
+        {
+            match.score = std::max(match.score, score);
+        }
+        else if (score > match.score)
+        {
+            match.runnerUp = match.score;
+            match.score = score;
+            bestIntent = m_phraseIntents[phrase];
+        }
+        else
+        {
+            match.runnerUp = std::max(match.runnerUp, score);
+        }
+    }
+    if (bestIntent >= 0)
+    {
+        match.command = m_intents[bestIntent].command;
+    }
+    return match;
+}
+
+/**
+ *
+ * START OF LOCAL_INTENTS
+ *
+ */
+
+bool LocalIntents::Load(const std::string &path, double threshold)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        yCError(LOCAL_INTENTS) << "Cannot open the intents file" << path;
+        return false;
+    }
+    try
+    {
+        nlohmann::json intents = nlohmann::json::parse(file);
+        m_phrases.clear();
+        for (const auto &language : intents.items())
+        {
+            for (const auto &command : language.value().items())
+            {
+                m_phrases[language.key()][command.key()] = command.value().get<std::vector<std::string>>();
+            }
+        }
+    }
+    catch (const nlohmann::json::exception &e)
+    {
+        yCError(LOCAL_INTENTS) << "The intents file" << path << "is not valid:" << e.what();
+        return false;
+    }
+    m_threshold = threshold;
+    return true;
+}
+
+bool LocalIntents::IsLoaded() const
+{
+    return !m_phrases.empty();
+}
+
+void LocalIntents::SetLanguage(const TourModel &tour, const LanguageSet &languageSet)
+{
+    if (!IsLoaded())
+    {
+        return;
+    }
+    std::vector<IntentIndex::Intent> intents;
+    auto phrases = m_phrases.find(tour.getLanguageName(languageSet.language));
+    if (phrases != m_phrases.end())
+    {
+        for (const auto &command : phrases->second)
+        {
+            CommandId commandId = tour.getCommandId(command.first);
+            IntentIndex::Intent intent;
+            intent.command = command.first;
+            intent.phrases = command.second;
+            intent.isGeneric = languageSet.genericPoI && languageSet.genericPoI->isCommandValid(commandId);
+            for (const PoIView *poi : languageSet.activePoIs)
+            {
+                if (poi && poi->isCommandValid(commandId))
+                {
+                    intent.pois.insert(poi->getName());
+                }
+            }
+            if (intent.isGeneric || !intent.pois.empty()) // The commands of other tours are left to googleDialog
+            {
+                intents.push_back(std::move(intent));
+            }
+        }
+    }
+    m_index.publish(std::make_unique<const IntentIndex>(intents));
+    yCDebug(LOCAL_INTENTS) << "Indexed" << intents.size() << "commands for the local intents";
+}
+
+bool LocalIntents::Match(const std::string &text, const std::string &poiName, std::string &outCommand)
+{
+    m_utterances++;
+    IntentIndex::Match match;
+    if (auto index = m_index.read())
+    {
+        match = index->Find(text, poiName);
+    }
+    if (match.command.empty() || match.score < m_threshold || match.score - match.runnerUp < m_margin)
+    {
+        yCDebug(LOCAL_INTENTS) << "No confident local intent for:" << text << "best:" << match.command << match.score;
+        return false;
+    }
+    m_hits++;
+    outCommand = match.command;
+    yCDebug(LOCAL_INTENTS) << "Matched locally" << text << "to" << outCommand << "with score" << match.score;
+    return true;
+}
+
+void LocalIntents::OnForwarded()
+{
+    m_forwardTime = yarp::os::Time::now();
+}
+
+void LocalIntents::OnDialogResult()
+{
+    double forwardTime = m_forwardTime.exchange(-1.0);
+    if (forwardTime >= 0.0)
+    {
+        m_roundTrips++;
+        m_roundTripMicroseconds += static_cast<std::int64_t>((yarp::os::Time::now() - forwardTime) * 1e6);
+    }
+}
+
+void LocalIntents::LogStatistics()
+{
+    if (!IsLoaded())
+    {
+        return;
+    }
+    std::uint64_t utterances = m_utterances;
+    std::uint64_t hits = m_hits;
+    std::uint64_t roundTrips = m_roundTrips;
+    double meanRoundTrip = roundTrips ? m_roundTripMicroseconds / 1e6 / roundTrips : 0.0;
+    yCInfo(LOCAL_INTENTS) << "Local intents matched" << hits << "of" << utterances << "utterances (hit rate"
+                          << (utterances ? 100.0 * hits / utterances : 0.0) << "%). Mean googleDialog round trip:" << meanRoundTrip
+                          << "s, estimated latency saved:" << hits * meanRoundTrip << "s";
+}
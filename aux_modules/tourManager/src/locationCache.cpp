@@ -0,0 +1,165 @@
+#include <locationCache.h>
+#include <yarp/os/LogStream.h>
+#include <algorithm>
+#include <chrono>
+
+YARP_LOG_COMPONENT(LOCATION_CACHE, "behavior_tour_robot.aux_modules.TourManager.LocationCache", yarp::os::Log::TraceType)
+
+LocationCache::~LocationCache()
+{
+    Stop();
+}
+
+void LocationCache::Start(NavigationInterface *navigation, double refreshPeriod)
+{
+    Stop();
+    m_navigation = navigation;
+    m_refreshPeriod = refreshPeriod;
+    m_isStopping = false;
+    Refresh(); // All the locations are available before the first navigation
+    m_thread = std::thread([this]
+                           { Run(); });
+}
+
+void LocationCache::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+        m_requests.clear();
+    }
+    m_hasRequests.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void LocationCache::SetNames(const std::vector<std::string> &names)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_names = names;
+    for (const std::string &name : m_names)
+    {
+        if (!m_locations.count(name))
+        {
+            m_requests.push_back(name);
+        }
+    }
+    m_hasRequests.notify_one();
+}
+
+bool LocationCache::Get(const std::string &name, yarp::dev::Nav2D::Map2DLocation &outLocation)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_locations.find(name);
+        if (found != m_locations.end())
+        {
+            m_hits++;
+            outLocation = found->second;
+            return true;
+        }
+        m_misses++;
+    }
+
+    if (!Resolve(name))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outLocation = m_locations[name];
+    return true;
+}
+
+void LocationCache::Prefetch(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (std::find(m_requests.begin(), m_requests.end(), name) == m_requests.end())
+    {
+        m_requests.push_back(name);
+        m_hasRequests.notify_one();
+    }
+}
+
+void LocationCache::Invalidate(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_locations.erase(name);
+}
+
+void LocationCache::LogStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    yCInfo(LOCATION_CACHE) << "Location cache hits:" << m_hits << "misses:" << m_misses;
+}
+
+bool LocationCache::Resolve(const std::string &name)
+{
+    yarp::dev::Nav2D::Map2DLocation location;
+    if (!m_navigation || !m_navigation->getLocation(name, location))
+    {
+        yCWarning(LOCATION_CACHE) << "Could not get the location" << name << "from the map server";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_locations.find(name);
+    if (found == m_locations.end())
+    {
+        m_locations.emplace(name, location);
+    }
+    else if (found->second != location)
+    {
+        yCInfo(LOCATION_CACHE) << "The location" << name << "has changed on the map server. Updating it.";
+        found->second = location;
+    }
+    return true;
+}
+
+void LocationCache::Refresh()
+{
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        names = m_names;
+    }
+    for (const std::string &name : names)
+    {
+        if (!Resolve(name))
+        {
+            Invalidate(name); // Removed from the map server
+        }
+    }
+}
+
+void LocationCache::Run()
+{
+    auto nextRefresh = std::chrono::steady_clock::now() + std::chrono::duration<double>(m_refreshPeriod);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_isStopping)
+    {
+        m_hasRequests.wait_until(lock, nextRefresh, [this]
+                                 { return m_isStopping || !m_requests.empty(); });
+        if (m_isStopping)
+        {
+            break;
+        }
+
+        if (!m_requests.empty())
+        {
+            std::string name = std::move(m_requests.front());
+            m_requests.pop_front();
+            lock.unlock();
+            Resolve(name);
+            lock.lock();
+        }
+        else
+        {
+            lock.unlock();
+            Refresh();
+            lock.lock();
+            nextRefresh = std::chrono::steady_clock::now() + std::chrono::duration<double>(m_refreshPeriod);
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/RFModule.h>
 #include <tourManager.h>
+#include <tourClock.h>
 #include <yarp/os/LogStream.h>
 
 int main(int argc, char *argv[])
@@ -9,14 +10,29 @@ int main(int argc, char *argv[])
 
     yarp::os::ResourceFinder rf;
     rf.configure(argc, argv);
+    if (!ConfigureClock(rf))
+    {
+        yError() << "Invalid clock options!";
+        return EXIT_FAILURE;
+    }
     std::string name = rf.check("name") ? rf.find("name").asString() : "TourManager";
     std::string nameJSONTours = rf.check("nameJSONTours") ? rf.find("nameJSONTours").asString() : "tours.json";
     std::string nameJSONMovements = rf.check("nameJSONMovements") ? rf.find("nameJSONMovements").asString() : "movements.json";
     std::string tourName = rf.check("tourName") ? rf.find("tourName").asString() : "TOUR_SIM_GAM";
     std::string pathJSONTours = rf.findFileByName(nameJSONTours);
     std::string pathJSONMovements = rf.findFileByName(nameJSONMovements);
+    std::string pathSnapshot = rf.check("nameSnapshot") ? rf.findFileByName(rf.find("nameSnapshot").asString()) : ""; // Precompiled by the tourCompiler
+    std::vector<std::string> languages; // Languages of the tour to load. If empty, all of them are loaded
+    if (rf.check("languages"))
+    {
+        yarp::os::Bottle *languagesList = rf.find("languages").asList();
+        for (size_t i = 0; languagesList && i < languagesList->size(); i++)
+        {
+            languages.push_back(languagesList->get(i).asString());
+        }
+    }
 
-    TourManager manager(name, pathJSONTours, pathJSONMovements, tourName);
+    TourManager manager(name, pathJSONTours, pathJSONMovements, tourName, languages, pathSnapshot);
     yInfo() << "Configuring and starting module...";
     // This calls configure(rf) and, upon success, the module execution begins with a call to updateModule()
     if (!manager.runModule(rf))
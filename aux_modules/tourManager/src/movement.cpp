@@ -17,12 +17,36 @@ float Movement::GetOffset() const
     return m_offset;
 }
 
-std::string Movement::GetPartName() const
+const std::string &Movement::GetPartName() const
 {
     return m_partName;
 }
 
-std::vector<float> Movement::GetJoints() const
+const std::vector<float> &Movement::GetJoints() const
 {
     return m_joints;
 }
+
+void Movement::BuildCommand()
+{
+    std::shared_ptr<yarp::os::Bottle> cmd = std::make_shared<yarp::os::Bottle>();
+    cmd->addVocab32("ctpq");
+    cmd->addVocab32("time");
+    cmd->addFloat64(m_time);
+    cmd->addVocab32("off");
+    cmd->addFloat64(m_offset);
+    cmd->addVocab32("pos");
+    yarp::os::Bottle &list = cmd->addList();
+    for (auto joint : m_joints)
+    {
+        list.addFloat64(joint);
+    }
+    size_t size;
+    cmd->toBinary(&size); // Serializes the bottle now. The encoding is cached and reused by every write
+    m_command = std::move(cmd);
+}
+
+const std::shared_ptr<const yarp::os::Bottle> &Movement::GetCommand() const
+{
+    return m_command;
+}
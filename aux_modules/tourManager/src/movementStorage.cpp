@@ -8,28 +8,103 @@ YARP_LOG_COMPONENT(MOVEMENT_STORAGE, "behavior_tour_robot.aux_modules.movementst
  *
  */
 
-MovementStorage &MovementStorage::GetInstance(const std::string &pathJSONMovements)
+MovementStorage &MovementStorage::GetInstance()
 {
     static MovementStorage instance; // Guaranteed to be destroyed. Instantiated on first use.
+    return instance;
+}
+
+MovementStorage &MovementStorage::GetInstance(const std::string &pathJSONMovements)
+{
+    MovementStorage &instance = GetInstance();
     instance.LoadMovements(pathJSONMovements);
     return instance;
 }
 
+MovementStorage &MovementStorage::GetInstance(const TourSnapshot &snapshot)
+{
+    MovementStorage &instance = GetInstance();
+    instance.LoadMovements(snapshot);
+    return instance;
+}
+
 bool MovementStorage::LoadMovements(const std::string &pathJSONMovements)
+{
+    std::unique_ptr<MovementsContainer> loadedMovements = BuildMovements(pathJSONMovements);
+    if (!loadedMovements)
+    {
+        return false;
+    }
+    Publish(std::move(loadedMovements));
+    return true;
+}
+
+bool MovementStorage::LoadMovements(const TourSnapshot &snapshot)
+{
+    std::unique_ptr<MovementsContainer> loadedMovements = BuildMovements(snapshot);
+    if (!loadedMovements)
+    {
+        return false;
+    }
+    Publish(std::move(loadedMovements));
+    return true;
+}
+
+std::unique_ptr<MovementsContainer> MovementStorage::BuildMovements(const std::string &pathJSONMovements)
 {
     // Load movements
-    nlohmann::ordered_json movements_json = ReadFileAsJSON(pathJSONMovements);
-    MovementsContainer loadedMovements = movements_json.get<MovementsContainer>();
-    m_movementsContainer = loadedMovements;
-    yCInfo(MOVEMENT_STORAGE) << "Loaded:" << m_movementsContainer.GetPartNames().size() << "robot parts.";
-    yCInfo(MOVEMENT_STORAGE) << "Loaded:" << m_movementsContainer.GetDances().size() << "dances.";
+    std::unique_ptr<MovementsContainer> loadedMovements;
+    try
+    {
+        nlohmann::ordered_json movements_json = ReadFileAsJSON(pathJSONMovements);
+        loadedMovements = std::make_unique<MovementsContainer>(movements_json.get<MovementsContainer>());
+    }
+    catch (const std::exception &e)
+    {
+        yCError(MOVEMENT_STORAGE) << "Movements" << pathJSONMovements << "are not valid:" << e.what(); // The previously loaded movements, if any, are kept
+        return nullptr;
+    }
 
-    for (auto &dance : m_movementsContainer.GetDances()) // Needs to be done here as json parser calls the default contructor and copies variables
+    for (auto &dance : loadedMovements->GetDances()) // Needs to be done here as json parser calls the default contructor and copies variables
     {
         dance.second.UpdateDuration();
+        dance.second.BuildCommands(); // The commands are encoded once here and reused by every dispatch
     }
+    return loadedMovements;
+}
 
-    return true;
+std::unique_ptr<MovementsContainer> MovementStorage::BuildMovements(const TourSnapshot &snapshot)
+{
+    // The snapshot is decoded straight into the container, without a json DOM
+    std::unique_ptr<MovementsContainer> loadedMovements = std::make_unique<MovementsContainer>();
+    std::map<std::string, float> durations;
+    if (!snapshot.ReadMovements(*loadedMovements, durations))
+    {
+        yCError(MOVEMENT_STORAGE) << "Movements not found in the snapshot";
+        return nullptr;
+    }
+
+    for (auto &dance : loadedMovements->GetDances()) // The durations have been precomputed by the tourCompiler
+    {
+        auto duration = durations.find(dance.first);
+        if (duration != durations.end())
+        {
+            dance.second.SetDuration(duration->second);
+        }
+        else
+        {
+            dance.second.UpdateDuration();
+        }
+        dance.second.BuildCommands(); // The commands are encoded once here and reused by every dispatch
+    }
+    return loadedMovements;
+}
+
+void MovementStorage::Publish(std::unique_ptr<MovementsContainer> movementsContainer)
+{
+    yCInfo(MOVEMENT_STORAGE) << "Loaded:" << movementsContainer->GetPartNames().size() << "robot parts.";
+    yCInfo(MOVEMENT_STORAGE) << "Loaded:" << movementsContainer->GetDances().size() << "dances.";
+    m_movementsContainer.publish(std::move(movementsContainer)); // Readers that pinned the previous container keep using it until they release it
 }
 
 nlohmann::ordered_json MovementStorage::ReadFileAsJSON(const std::string &path)
@@ -39,9 +114,9 @@ nlohmann::ordered_json MovementStorage::ReadFileAsJSON(const std::string &path)
     return nlohmann::ordered_json::parse(sentence);
 }
 
-MovementsContainer &MovementStorage::GetMovementsContainer()
+MovementStorage::ContainerGuard MovementStorage::GetMovementsContainer() const
 {
-    return m_movementsContainer;
+    return m_movementsContainer.read();
 }
 
 /**
@@ -66,11 +141,27 @@ std::set<std::string> &MovementsContainer::GetPartNames()
     return m_partNames;
 }
 
+const std::set<std::string> &MovementsContainer::GetPartNames() const
+{
+    return m_partNames;
+}
+
 std::map<std::string, Dance> &MovementsContainer::GetDances()
 {
     return m_dances;
 }
 
+const std::map<std::string, Dance> &MovementsContainer::GetDances() const
+{
+    return m_dances;
+}
+
+const Dance *MovementsContainer::FindDance(const std::string &danceName) const
+{
+    auto foundDance = m_dances.find(danceName);
+    return foundDance != m_dances.end() ? &foundDance->second : nullptr;
+}
+
 bool MovementsContainer::GetDance(const std::string &danceName, Dance &outDance) const
 {
     auto foundDance = m_dances.find(danceName);
@@ -0,0 +1,35 @@
+#include <navigation.h>
+
+Nav2DNavigation::Nav2DNavigation(yarp::dev::Nav2D::INavigation2D *iNav2D) : m_iNav2D(iNav2D)
+{
+}
+
+bool Nav2DNavigation::getLocation(const std::string &locationName, yarp::dev::Nav2D::Map2DLocation &location)
+{
+    return m_iNav2D->getLocation(locationName, location);
+}
+
+bool Nav2DNavigation::gotoTargetByLocationName(const std::string &locationName)
+{
+    return m_iNav2D->gotoTargetByLocationName(locationName);
+}
+
+bool Nav2DNavigation::getNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum &status)
+{
+    return m_iNav2D->getNavigationStatus(status);
+}
+
+bool Nav2DNavigation::stopNavigation()
+{
+    return m_iNav2D->stopNavigation();
+}
+
+bool Nav2DNavigation::suspendNavigation(double time)
+{
+    return m_iNav2D->suspendNavigation(time);
+}
+
+bool Nav2DNavigation::resumeNavigation()
+{
+    return m_iNav2D->resumeNavigation();
+}
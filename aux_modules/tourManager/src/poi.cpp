@@ -71,3 +71,8 @@ std::vector<std::string> PoI::getAvailableCommands()
     }
     return availableCommands;
 }
+
+const std::unordered_map<std::string, std::vector<Action>> &PoI::getAvailableActions() const
+{
+    return m_availableActions;
+}
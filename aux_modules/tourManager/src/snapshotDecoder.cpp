@@ -0,0 +1,428 @@
+#include "snapshotDecoder.h"
+
+namespace
+{
+    // Fields of an Action and of a Movement, all of them are required as in their json deserialization
+    constexpr int ACTION_TYPE = 1 << 0;
+    constexpr int ACTION_IS_BLOCKING = 1 << 1;
+    constexpr int ACTION_PARAM = 1 << 2;
+    constexpr int ACTION_FIELDS = ACTION_TYPE | ACTION_IS_BLOCKING | ACTION_PARAM;
+
+    constexpr int MOVEMENT_TIME = 1 << 0;
+    constexpr int MOVEMENT_OFFSET = 1 << 1;
+    constexpr int MOVEMENT_PART_NAME = 1 << 2;
+    constexpr int MOVEMENT_JOINTS = 1 << 3;
+    constexpr int MOVEMENT_FIELDS = MOVEMENT_TIME | MOVEMENT_OFFSET | MOVEMENT_PART_NAME | MOVEMENT_JOINTS;
+
+    const std::string NO_KEY;
+}
+
+/**
+ *
+ * START OF SNAPSHOT_DECODER
+ *
+ */
+
+bool SnapshotDecoder::startContainer(bool isArray)
+{
+    m_keys.push_back(m_isArray.empty() || m_isArray.back() ? NO_KEY : m_key);
+    m_isArray.push_back(isArray);
+
+    if (m_skipDepth >= 0)
+    {
+        return true;
+    }
+    if (!enter(isArray))
+    {
+        if (!m_error.empty())
+        {
+            return false;
+        }
+        m_skipDepth = depth();
+    }
+    return true;
+}
+
+bool SnapshotDecoder::endContainer()
+{
+    bool result = true;
+    if (m_skipDepth == depth())
+    {
+        m_skipDepth = -1;
+    }
+    else if (m_skipDepth < 0)
+    {
+        result = leave();
+    }
+    m_keys.pop_back();
+    m_isArray.pop_back();
+    return result;
+}
+
+bool SnapshotDecoder::addValue(const nlohmann::json &val)
+{
+    if (m_skipDepth >= 0 || m_isArray.empty())
+    {
+        return true;
+    }
+    return value(val);
+}
+
+bool SnapshotDecoder::fail(const std::string &error)
+{
+    m_error = error;
+    return false;
+}
+
+int SnapshotDecoder::depth() const
+{
+    return static_cast<int>(m_keys.size());
+}
+
+const std::string &SnapshotDecoder::keyAt(int level) const
+{
+    return m_keys.at(level - 1);
+}
+
+const std::string &SnapshotDecoder::currentKey() const
+{
+    return m_isArray.empty() || m_isArray.back() ? NO_KEY : m_key;
+}
+
+bool SnapshotDecoder::null()
+{
+    return addValue(nullptr);
+}
+
+bool SnapshotDecoder::boolean(bool val)
+{
+    return addValue(val);
+}
+
+bool SnapshotDecoder::number_integer(number_integer_t val)
+{
+    return addValue(val);
+}
+
+bool SnapshotDecoder::number_unsigned(number_unsigned_t val)
+{
+    return addValue(val);
+}
+
+bool SnapshotDecoder::number_float(number_float_t val, const string_t &)
+{
+    return addValue(val);
+}
+
+bool SnapshotDecoder::string(string_t &val)
+{
+    return addValue(val);
+}
+
+bool SnapshotDecoder::binary(binary_t &)
+{
+    return fail("unexpected binary value");
+}
+
+bool SnapshotDecoder::start_object(std::size_t)
+{
+    return startContainer(false);
+}
+
+bool SnapshotDecoder::key(string_t &val)
+{
+    m_key = val;
+    return true;
+}
+
+bool SnapshotDecoder::end_object()
+{
+    return endContainer();
+}
+
+bool SnapshotDecoder::start_array(std::size_t)
+{
+    return startContainer(true);
+}
+
+bool SnapshotDecoder::end_array()
+{
+    return endContainer();
+}
+
+bool SnapshotDecoder::parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex)
+{
+    return fail(ex.what());
+}
+
+const std::string &SnapshotDecoder::getError() const
+{
+    return m_error;
+}
+
+/**
+ *
+ * START OF TOUR_DECODER
+ *
+ */
+
+TourDecoder::TourDecoder(const std::vector<std::string> &enabledLanguages) : m_enabledLanguages(enabledLanguages.begin(), enabledLanguages.end())
+{
+}
+
+bool TourDecoder::enter(bool isArray)
+{
+    switch (depth())
+    {
+    case 1: // The tour
+        return !isArray || fail("the tour is not an object");
+    case 2:
+        if (keyAt(2) == "m_availablePoIs")
+        {
+            m_hasAvailablePoIs = true;
+            return !isArray || fail("m_availablePoIs is not an object");
+        }
+        if (keyAt(2) == "m_activeTourPoIs")
+        {
+            m_hasActiveTourPoIs = true;
+            return isArray || fail("m_activeTourPoIs is not an array");
+        }
+        return false;
+    case 3: // A language, the disabled ones are skipped
+        if (keyAt(2) != "m_availablePoIs" || (!m_enabledLanguages.empty() && m_enabledLanguages.count(keyAt(3)) == 0))
+        {
+            return false;
+        }
+        m_availablePoIs[keyAt(3)];
+        return !isArray || fail("language " + keyAt(3) + " is not an object");
+    case 4: // A PoI
+        m_hasPoIName = false;
+        m_hasAvailableActions = false;
+        m_availableActions.clear();
+        return !isArray || fail("PoI " + keyAt(4) + " is not an object");
+    case 5:
+        if (keyAt(5) != "m_availableActions")
+        {
+            return false;
+        }
+        m_hasAvailableActions = true;
+        return !isArray || fail("m_availableActions of PoI " + keyAt(4) + " is not an object");
+    case 6: // The actions of a command
+        m_actions.clear();
+        return isArray || fail("command " + keyAt(6) + " of PoI " + keyAt(4) + " is not an array");
+    case 7: // An action
+        m_actionFields = 0;
+        return !isArray || fail("an action of command " + keyAt(6) + " of PoI " + keyAt(4) + " is not an object");
+    default:
+        return false;
+    }
+}
+
+bool TourDecoder::leave()
+{
+    switch (depth())
+    {
+    case 4:
+        if (!m_hasPoIName || !m_hasAvailableActions)
+        {
+            return fail("PoI " + keyAt(4) + " has no m_name or m_availableActions");
+        }
+        m_availablePoIs[keyAt(3)].insert_or_assign(keyAt(4), PoI(std::move(m_poiName), std::move(m_availableActions)));
+        m_availableActions.clear();
+        return true;
+    case 6:
+        m_availableActions.insert_or_assign(keyAt(6), std::move(m_actions));
+        m_actions.clear();
+        return true;
+    case 7:
+        if (m_actionFields != ACTION_FIELDS)
+        {
+            return fail("an action of command " + keyAt(6) + " of PoI " + keyAt(4) + " has missing fields");
+        }
+        m_actions.emplace_back(m_type, m_isBlocking, std::move(m_param));
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool TourDecoder::value(const nlohmann::json &value)
+{
+    if (depth() == 2 && keyAt(2) == "m_activeTourPoIs")
+    {
+        m_activeTourPoIs.push_back(value.get<std::string>());
+    }
+    else if (depth() == 4 && currentKey() == "m_name")
+    {
+        m_poiName = value.get<std::string>();
+        m_hasPoIName = true;
+    }
+    else if (depth() == 7 && currentKey() == "m_type")
+    {
+        m_type = value.get<ActionTypes>();
+        m_actionFields |= ACTION_TYPE;
+    }
+    else if (depth() == 7 && currentKey() == "m_isBlocking")
+    {
+        m_isBlocking = value.get<bool>();
+        m_actionFields |= ACTION_IS_BLOCKING;
+    }
+    else if (depth() == 7 && currentKey() == "m_param")
+    {
+        m_param = value.get<std::string>();
+        m_actionFields |= ACTION_PARAM;
+    }
+    return true;
+}
+
+bool TourDecoder::isComplete() const
+{
+    return getError().empty() && m_hasAvailablePoIs && m_hasActiveTourPoIs;
+}
+
+Tour TourDecoder::getTour()
+{
+    return Tour("", std::move(m_availablePoIs), std::move(m_activeTourPoIs));
+}
+
+/**
+ *
+ * START OF MOVEMENTS_DECODER
+ *
+ */
+
+bool MovementsDecoder::enter(bool isArray)
+{
+    switch (depth())
+    {
+    case 1: // The blob
+        return !isArray || fail("the movements blob is not an object");
+    case 2:
+        if (keyAt(2) == "movements")
+        {
+            m_hasMovements = true;
+            return !isArray || fail("the movements are not an object");
+        }
+        if (keyAt(2) == "durations")
+        {
+            return !isArray || fail("the durations are not an object");
+        }
+        return false;
+    case 3:
+        if (keyAt(2) != "movements")
+        {
+            return false;
+        }
+        if (keyAt(3) == "m_partNames")
+        {
+            m_hasPartNames = true;
+            return isArray || fail("m_partNames is not an array");
+        }
+        if (keyAt(3) == "m_dances")
+        {
+            m_hasDances = true;
+            return !isArray || fail("m_dances is not an object");
+        }
+        return false;
+    case 4: // A dance
+        if (keyAt(3) != "m_dances")
+        {
+            return false;
+        }
+        m_hasDanceMovements = false;
+        m_movements.clear();
+        return !isArray || fail("dance " + keyAt(4) + " is not an object");
+    case 5:
+        if (keyAt(5) != "m_movements")
+        {
+            return false;
+        }
+        m_hasDanceMovements = true;
+        return isArray || fail("m_movements of dance " + keyAt(4) + " is not an array");
+    case 6: // A movement
+        m_movementFields = 0;
+        m_joints.clear();
+        return !isArray || fail("a movement of dance " + keyAt(4) + " is not an object");
+    case 7:
+        if (keyAt(7) != "m_joints")
+        {
+            return false;
+        }
+        m_movementFields |= MOVEMENT_JOINTS;
+        return isArray || fail("m_joints of a movement of dance " + keyAt(4) + " is not an array");
+    default:
+        return false;
+    }
+}
+
+bool MovementsDecoder::leave()
+{
+    switch (depth())
+    {
+    case 4:
+        if (!m_hasDanceMovements)
+        {
+            return fail("dance " + keyAt(4) + " has no m_movements");
+        }
+        m_dances.insert_or_assign(keyAt(4), Dance(std::move(m_movements)));
+        m_movements.clear();
+        return true;
+    case 6:
+        if (m_movementFields != MOVEMENT_FIELDS)
+        {
+            return fail("a movement of dance " + keyAt(4) + " has missing fields");
+        }
+        m_movements.emplace_back(m_time, m_offset, std::move(m_partName), std::move(m_joints));
+        m_joints.clear();
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool MovementsDecoder::value(const nlohmann::json &value)
+{
+    if (depth() == 2 && keyAt(2) == "durations")
+    {
+        m_durations[currentKey()] = value.get<float>();
+    }
+    else if (depth() == 3 && keyAt(3) == "m_partNames")
+    {
+        m_partNames.insert(value.get<std::string>());
+    }
+    else if (depth() == 6 && currentKey() == "m_time")
+    {
+        m_time = value.get<float>();
+        m_movementFields |= MOVEMENT_TIME;
+    }
+    else if (depth() == 6 && currentKey() == "m_offset")
+    {
+        m_offset = value.get<float>();
+        m_movementFields |= MOVEMENT_OFFSET;
+    }
+    else if (depth() == 6 && currentKey() == "m_partName")
+    {
+        m_partName = value.get<std::string>();
+        m_movementFields |= MOVEMENT_PART_NAME;
+    }
+    else if (depth() == 7)
+    {
+        m_joints.push_back(value.get<float>());
+    }
+    return true;
+}
+
+bool MovementsDecoder::isComplete() const
+{
+    return getError().empty() && m_hasMovements && m_hasPartNames && m_hasDances;
+}
+
+MovementsContainer MovementsDecoder::getMovements()
+{
+    return MovementsContainer(std::move(m_partNames), std::move(m_dances));
+}
+
+std::map<std::string, float> &MovementsDecoder::getDurations()
+{
+    return m_durations;
+}
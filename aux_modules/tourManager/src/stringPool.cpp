@@ -0,0 +1,65 @@
+#include <stringPool.h>
+#include <cstring>
+#include <string>
+
+StringPool::StringPool(std::size_t blockSize) : m_blockSize(blockSize)
+{
+}
+
+std::string_view StringPool::Intern(std::string_view text)
+{
+    static const std::size_t SSO_CAPACITY = std::string().capacity(); // Longer strings allocate their characters
+    m_statistics.interned++;
+    m_statistics.separateBytes += sizeof(std::string) + (text.size() > SSO_CAPACITY ? text.size() + 1 : 0);
+    if (text.empty())
+    {
+        return std::string_view();
+    }
+
+    auto found = m_index.find(text);
+    if (found != m_index.end())
+    {
+        return *found;
+    }
+
+    char *storage;
+    if (text.size() > m_blockSize / 4) // The long strings get their own allocation, so that they do not waste the end of a block
+    {
+        m_blocks.push_back(std::make_unique<char[]>(text.size()));
+        m_allocatedBytes += text.size();
+        storage = m_blocks.back().get();
+    }
+    else
+    {
+        if (text.size() > m_blockFree)
+        {
+            m_blocks.push_back(std::make_unique<char[]>(m_blockSize));
+            m_allocatedBytes += m_blockSize;
+            m_block = m_blocks.back().get();
+            m_blockFree = m_blockSize;
+        }
+        storage = m_block + (m_blockSize - m_blockFree);
+        m_blockFree -= text.size();
+    }
+    std::memcpy(storage, text.data(), text.size());
+
+    std::string_view pooled(storage, text.size());
+    m_index.insert(pooled);
+    m_statistics.unique++;
+    return pooled;
+}
+
+void StringPool::Seal()
+{
+    std::unordered_set<std::string_view>().swap(m_index);
+}
+
+StringPool::Statistics StringPool::GetStatistics() const
+{
+    Statistics statistics = m_statistics;
+    // The blocks, the nodes and buckets of the index, and a view for every handle given out
+    statistics.poolBytes = m_allocatedBytes + m_blocks.capacity() * sizeof(std::unique_ptr<char[]>) +
+                           m_index.size() * (sizeof(std::string_view) + sizeof(void *)) + m_index.bucket_count() * sizeof(void *) +
+                           m_statistics.interned * sizeof(std::string_view);
+    return statistics;
+}
@@ -0,0 +1,254 @@
+#include <telemetry.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+#include <algorithm>
+#include <cstdio>
+
+YARP_LOG_COMPONENT(TELEMETRY, "behavior_tour_robot.aux_modules.TourManager.Telemetry", yarp::os::Log::TraceType)
+
+/**
+ *
+ * START OF HISTOGRAM
+ *
+ */
+
+void Histogram::Record(double seconds)
+{
+    std::uint64_t microseconds = seconds > 0.0 ? static_cast<std::uint64_t>(seconds * 1e6) : 0;
+    int bucket = 0;
+    for (std::uint64_t value = microseconds; value > 0 && bucket < BUCKETS_NUM - 1; value >>= 1)
+    {
+        bucket++;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+    std::uint64_t max = m_maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > max && !m_maxMicroseconds.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+Histogram::Summary Histogram::Summarize() const
+{
+    Summary summary;
+    summary.count = m_count.load(std::memory_order_relaxed);
+    if (summary.count == 0)
+    {
+        return summary;
+    }
+    std::uint64_t maxMicroseconds = m_maxMicroseconds.load(std::memory_order_relaxed);
+    summary.mean = m_sumMicroseconds.load(std::memory_order_relaxed) / 1e6 / summary.count;
+    summary.p50 = Percentile(0.50, summary.count, maxMicroseconds);
+    summary.p90 = Percentile(0.90, summary.count, maxMicroseconds);
+    summary.p99 = Percentile(0.99, summary.count, maxMicroseconds);
+    summary.max = maxMicroseconds / 1e6;
+    return summary;
+}
+
+double Histogram::Percentile(double quantile, std::uint64_t count, std::uint64_t maxMicroseconds) const
+{
+    std::uint64_t cumulative = 0;
+    for (int bucket = 0; bucket < BUCKETS_NUM; bucket++)
+    {
+        cumulative += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (cumulative >= quantile * count)
+        {
+            std::uint64_t upperBound = bucket == 0 ? 0 : (std::uint64_t(1) << bucket) - 1;
+            return std::min(upperBound, maxMicroseconds) / 1e6;
+        }
+    }
+    return maxMicroseconds / 1e6; // Recorded while summarizing
+}
+
+/**
+ *
+ * START OF TELEMETRY
+ *
+ */
+
+Telemetry::ScopedTimer::ScopedTimer(Histogram &histogram) : m_histogram(histogram),
+                                                            m_startTime(yarp::os::Time::now())
+{
+}
+
+Telemetry::ScopedTimer::~ScopedTimer()
+{
+    m_histogram.Record(yarp::os::Time::now() - m_startTime);
+}
+
+Telemetry::Telemetry(double period) : yarp::os::PeriodicThread(period)
+{
+}
+
+bool Telemetry::Open(const std::string &portName, const std::string &filePath, std::size_t maxFileSize, const std::vector<std::string> &commands)
+{
+    m_commandNames = commands;
+    m_commandIndices.clear();
+    for (size_t i = 0; i < m_commandNames.size(); i++)
+    {
+        m_commandIndices.emplace(m_commandNames[i], i);
+    }
+    m_commands = std::make_unique<Histogram[]>(m_commandNames.size());
+
+    if (!m_port.open(portName))
+    {
+        yCError(TELEMETRY) << "Cannot open the telemetry port" << portName;
+        return false;
+    }
+    m_filePath = filePath;
+    m_maxFileSize = maxFileSize;
+    if (!m_filePath.empty())
+    {
+        m_file.open(m_filePath, std::ios::app);
+        if (!m_file)
+        {
+            yCWarning(TELEMETRY) << "Cannot open the telemetry file" << m_filePath << ". The telemetry is only published on the port.";
+        }
+    }
+    return true;
+}
+
+void Telemetry::Close()
+{
+    Publish();
+    m_port.close();
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    m_file.close();
+}
+
+void Telemetry::SetPoI(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_currentPoI = &m_poIs[name]; // The nodes of the map are never moved
+}
+
+void Telemetry::Record(PoIMetric metric, double seconds)
+{
+    if (PoIStatistics *poi = m_currentPoI.load(std::memory_order_acquire))
+    {
+        poi->metrics[static_cast<size_t>(metric)].Record(seconds);
+    }
+}
+
+void Telemetry::CountFallback()
+{
+    if (PoIStatistics *poi = m_currentPoI.load(std::memory_order_acquire))
+    {
+        poi->fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Histogram &Telemetry::GetCommandHistogram(const std::string &command)
+{
+    auto found = m_commandIndices.find(command);
+    return found != m_commandIndices.end() ? m_commands[found->second] : m_otherCommands;
+}
+
+void Telemetry::run()
+{
+    Publish();
+}
+
+const char *Telemetry::ToString(PoIMetric metric)
+{
+    switch (metric)
+    {
+    case PoIMetric::NAVIGATION:
+        return "navigation";
+    case PoIMetric::SPEECH_START:
+        return "speechStart";
+    case PoIMetric::SPEAKING:
+        return "speaking";
+    case PoIMetric::DANCE:
+        return "dance";
+    case PoIMetric::ERROR_RECOVERY:
+        return "errorRecovery";
+    default:
+        return "unknown";
+    }
+}
+
+void Telemetry::AddSummary(const Histogram::Summary &summary, yarp::os::Bottle &bottle, nlohmann::json &json)
+{
+    bottle.addInt64(static_cast<std::int64_t>(summary.count));
+    bottle.addFloat64(summary.mean);
+    bottle.addFloat64(summary.p50);
+    bottle.addFloat64(summary.p90);
+    bottle.addFloat64(summary.p99);
+    bottle.addFloat64(summary.max);
+    json = {{"count", summary.count}, {"mean", summary.mean}, {"p50", summary.p50}, {"p90", summary.p90}, {"p99", summary.p99}, {"max", summary.max}};
+}
+
+void Telemetry::Publish()
+{
+    std::lock_guard<std::mutex> publishLock(m_publishMutex);
+    double now = yarp::os::Time::now();
+    yarp::os::Bottle &output = m_port.prepare();
+    output.clear();
+    nlohmann::json json;
+    json["time"] = now;
+
+    // (time <t>) (pois (<poi> (<metric> count mean p50 p90 p99 max) ... (fallbacks <n>)) ...) (commands (<command> count mean p50 p90 p99 max) ...)
+    yarp::os::Bottle &time = output.addList();
+    time.addString("time");
+    time.addFloat64(now);
+    yarp::os::Bottle &pois = output.addList();
+    pois.addString("pois");
+    yarp::os::Bottle &commands = output.addList();
+    commands.addString("commands");
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &poi : m_poIs)
+        {
+            yarp::os::Bottle &poiBottle = pois.addList();
+            poiBottle.addString(poi.first);
+            nlohmann::json &poiJson = json["pois"][poi.first];
+            for (size_t i = 0; i < poi.second.metrics.size(); i++)
+            {
+                const char *metric = ToString(static_cast<PoIMetric>(i));
+                yarp::os::Bottle &metricBottle = poiBottle.addList();
+                metricBottle.addString(metric);
+                AddSummary(poi.second.metrics[i].Summarize(), metricBottle, poiJson[metric]);
+            }
+            std::uint64_t fallbacks = poi.second.fallbacks.load(std::memory_order_relaxed);
+            yarp::os::Bottle &fallbacksBottle = poiBottle.addList();
+            fallbacksBottle.addString("fallbacks");
+            fallbacksBottle.addInt64(static_cast<std::int64_t>(fallbacks));
+            poiJson["fallbacks"] = fallbacks;
+        }
+    }
+    for (size_t i = 0; i < m_commandNames.size(); i++)
+    {
+        yarp::os::Bottle &commandBottle = commands.addList();
+        commandBottle.addString(m_commandNames[i]);
+        AddSummary(m_commands[i].Summarize(), commandBottle, json["commands"][m_commandNames[i]]);
+    }
+    yarp::os::Bottle &otherBottle = commands.addList();
+    otherBottle.addString(OTHER_COMMANDS);
+    AddSummary(m_otherCommands.Summarize(), otherBottle, json["commands"][OTHER_COMMANDS]);
+
+    m_port.write();
+    WriteFile(json);
+}
+
+void Telemetry::WriteFile(const nlohmann::json &json)
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    m_file << json.dump() << '\n';
+    m_file.flush();
+    if (m_maxFileSize > 0 && static_cast<std::size_t>(m_file.tellp()) >= m_maxFileSize)
+    { // Roll the file, keeping only the previous one
+        m_file.close();
+        std::string previousPath = m_filePath + ".1";
+        std::remove(previousPath.c_str());
+        if (std::rename(m_filePath.c_str(), previousPath.c_str()) != 0)
+        {
+            yCWarning(TELEMETRY) << "Cannot roll the telemetry file" << m_filePath;
+        }
+        m_file.open(m_filePath, std::ios::trunc);
+    }
+}
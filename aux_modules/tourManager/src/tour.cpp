@@ -92,3 +92,8 @@ std::vector<std::string> Tour::getPoIsList() const
 {
     return m_activeTourPoIs;
 }
+
+const std::unordered_map<std::string, std::unordered_map<std::string, PoI>> &Tour::getAvailablePoIs() const
+{
+    return m_availablePoIs;
+}
@@ -1,8 +1,14 @@
 #include <tourManager.h>
+#include <unordered_set>
 
 YARP_LOG_COMPONENT(TOUR_MANAGER, "behavior_tour_robot.aux_modules.tourmanager", yarp::os::Log::TraceType)
 
-TourManager::TourManager(const std::string &name, const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &tourName) : m_name(name),
+namespace
+{
+    const std::string REPEAT_SPEECH_COMMAND = "repeatInterruptedSpeech"; // Not a command of the tour: says the interrupted sentence again
+}
+
+TourManager::TourManager(const std::string &name, const std::string &pathJSONTours, const std::string &pathJSONMovements, const std::string &tourName, const std::vector<std::string> &languages, const std::string &pathSnapshot) : m_name(name),
                                                                                                                                                          m_period(1.0),
                                                                                                                                                          m_random_gen(m_rand_engine()),
                                                                                                                                                          m_uniform_distrib(1, 2),
@@ -19,21 +25,39 @@ TourManager::TourManager(const std::string &name, const std::string &pathJSONTou
                                                                                                                                                          m_dialogflowOutputName("/" + name + "/dialogDialogOutput"),
                                                                                                                                                          m_dialogflowInputName("/" + name + "/googleDialogInput"),
                                                                                                                                                          m_tourManagerThriftPortName("/" + name + "/thrift:s"),
-                                                                                                                                                         m_PoIndex(0)
+                                                                                                                                                         m_speechStatusName("/" + name + "/speechStatus:i"),
+                                                                                                                                                         m_speechEventsName("/" + name + "/speechEvents:i"),
+                                                                                                                                                         m_transcriptionInputName("/" + name + "/speechTranscription:i"),
+                                                                                                                                                         m_languageOutputName("/" + name + "/language:o"),
+                                                                                                                                                         m_speechStatusCallback(m_events),
+                                                                                                                                                         m_speechEventsCallback(m_events),
+                                                                                                                                                         m_navigationMonitor(m_events, 0.05),
+                                                                                                                                                         m_contentReloader(pathJSONTours, pathJSONMovements, pathSnapshot, tourName, languages),
+                                                                                                                                                         m_tourGeneration(0),
+                                                                                                                                                         m_PoIndex(0),
+                                                                                                                                                         m_tourStorage(nullptr),
+                                                                                                                                                         m_moveStorage(nullptr),
+                                                                                                                                                         m_telemetry(5.0),
+                                                                                                                                                         m_commandExecutor([this](const std::string &command, const CancellationToken &token)
+                                                                                                                                                                           { return InterpretCommand(command, token); })
 
 {
-    m_tourStorage = &TourStorage::GetInstance(pathJSONTours, tourName); // Loads the tour json from the file and saves a reference to the class.
-    m_moveStorage = &MovementStorage::GetInstance(pathJSONMovements);   // Loads the movements json from the file and saves a reference to the class.
+    m_contentReloader.Load(); // Loads the selected tour and the movements, preferring the precompiled snapshot if available
+    m_tourStorage = &TourStorage::GetInstance();
+    m_moveStorage = &MovementStorage::GetInstance();
 }
 
 bool TourManager::configure(yarp::os::ResourceFinder &rf)
 {
     m_dialogflowCallback = new DialogflowCallback(this);
 
-    m_tourStorage->GetTour().setCurrentLanguage("it-IT");
-    UpdatePoI();
+    if (!m_tourStorage->GetTourModel())
+    {
+        yCError(TOUR_MANAGER) << "No tour was loaded.";
+        return false;
+    }
 
-    if (!m_tourStorage->GetTour().getPoI("___generic___", m_genericPoI))
+    if (!UpdateLanguage("it-IT"))
     {
         yCError(TOUR_MANAGER) << "Generic PoI failed to update for the first time.";
         return false;
@@ -86,8 +110,39 @@ bool TourManager::configure(yarp::os::ResourceFinder &rf)
     }
     yarp::os::Network::connect(m_dialogflowOutputName, "/googleDialog/text:i");
 
+    // The transcriptions of googleSpeech are connected here by the application and forwarded to googleDialog, unless matched locally
+    m_transcriptionCallback = new TranscriptionCallback(this);
+    if (!m_pTranscriptionInput.open(m_transcriptionInputName))
+    {
+        yCError(TOUR_MANAGER, "Cannot open speechTranscription port");
+        return false;
+    }
+    m_pTranscriptionInput.useCallback(*m_transcriptionCallback);
+
+    // --------- Local intents --------- //
+    if (rf.check("localIntents"))
+    {
+        double threshold = rf.check("localIntentThreshold") ? rf.find("localIntentThreshold").asFloat64() : 0.8;
+        if (m_localIntents.Load(rf.findFileByName(rf.find("localIntents").asString()), threshold))
+        {
+            TourView tour = AcquireTour();
+            if (tour && tour.languageSet)
+            {
+                m_localIntents.SetLanguage(*tour, *tour.languageSet);
+            }
+        }
+        else
+        {
+            yCWarning(TOUR_MANAGER) << "The local intents are disabled. Every transcription is sent to googleDialog.";
+        }
+    }
+
     // Ctp Service
-    std::set<std::string> ctpServiceParts = m_moveStorage->GetMovementsContainer().GetPartNames();
+    std::set<std::string> ctpServiceParts;
+    if (MovementStorage::ContainerGuard movements = m_moveStorage->GetMovementsContainer())
+    {
+        ctpServiceParts = movements->GetPartNames();
+    }
     if (!ctpServiceParts.empty())
     {
         for (std::string part : ctpServiceParts)
@@ -102,6 +157,7 @@ bool TourManager::configure(yarp::os::ResourceFinder &rf)
             }
             m_pCtpService.insert({part, *ctpPort});
             yarp::os::Network::connect(portName, "/ctpservice/" + part + "/rpc");
+            m_ctpDispatcher.AddPart(part, *ctpPort);
         }
     }
     else
@@ -123,6 +179,111 @@ bool TourManager::configure(yarp::os::ResourceFinder &rf)
     }
 
     // --------- navigation2D_nwc_yarp config --------- //
+    if (!m_navigation && !OpenNavigation(rf)) // Unless a navigation has been given by the application
+    {
+        return false;
+    }
+
+    // --------- Completion events --------- //
+    if (!m_pSpeechStatus.open(m_speechStatusName))
+    {
+        yCError(TOUR_MANAGER, "Cannot open speechStatus port");
+        return false;
+    }
+    m_pSpeechStatus.useCallback(m_speechStatusCallback);
+    if (!yarp::os::Network::connect("/HeadSynchronizer/speechStatus:o", m_speechStatusName))
+    {
+        yCWarning(TOUR_MANAGER) << "Cannot connect to the speech status of the headSynchronizer. The end of the speech will be polled.";
+    }
+    if (!m_pSpeechEvents.open(m_speechEventsName))
+    {
+        yCError(TOUR_MANAGER, "Cannot open speechEvents port");
+        return false;
+    }
+    m_pSpeechEvents.setStrict(); // An event lost would leave the wait for its utterance to the polling
+    m_pSpeechEvents.useCallback(m_speechEventsCallback);
+    if (!yarp::os::Network::connect("/HeadSynchronizer/speechEvents:o", m_speechEventsName))
+    {
+        yCWarning(TOUR_MANAGER) << "Cannot connect to the speech events of the headSynchronizer. The end of the speech will be waited on the speech status.";
+    }
+    if (!m_pLanguageOutput.open(m_languageOutputName))
+    {
+        yCError(TOUR_MANAGER, "Cannot open language port");
+        return false;
+    }
+
+    if (rf.check("navigationStatusPeriod"))
+    {
+        m_navigationMonitor.setPeriod(rf.find("navigationStatusPeriod").asFloat64());
+    }
+    // --------- Location cache --------- //
+    double locationRefreshPeriod = rf.check("locationRefreshPeriod") ? rf.find("locationRefreshPeriod").asFloat64() : 10.0;
+    if (TourView tour = AcquireTour())
+    {
+        m_locationCache.SetNames(GetActivePoINames(*tour));
+    }
+    m_locationCache.Start(m_navigation, locationRefreshPeriod);
+    m_jobPool.Start(rf.check("jobWorkers") ? rf.find("jobWorkers").asInt32() : 2);
+
+    if (rf.check("commandTick"))
+    {
+        m_commandTick = rf.find("commandTick").asFloat64();
+    }
+    m_commandExecutor.Start();
+
+    m_isTransitionPipelined = rf.check("pipelinedTransition") ? rf.find("pipelinedTransition").asBool() : false;
+    m_isPoseInterlocked = rf.check("navigationPoseInterlock") ? rf.find("navigationPoseInterlock").asBool() : true;
+
+    m_navigationMonitor.SetNavigation(m_navigation);
+    if (!m_navigationMonitor.start())
+    {
+        yCError(TOUR_MANAGER) << "Cannot start the navigation monitor";
+        return false;
+    }
+    m_navigationMonitor.suspend(); // Resumed only while a navigation is active
+
+    // --------- Hot reload of the content --------- //
+    bool watchContent = rf.check("watchContent") ? rf.find("watchContent").asBool() : true;
+    double watchPeriod = rf.check("watchPeriod") ? rf.find("watchPeriod").asFloat64() : 1.0;
+    m_contentReloader.SetWatch(watchContent, watchPeriod);
+    if (rf.check("reloadTimeout"))
+    {
+        m_reloadTimeout = rf.find("reloadTimeout").asFloat64();
+    }
+    if (!m_contentReloader.start())
+    {
+        yCWarning(TOUR_MANAGER) << "Cannot start the content reloader. The content will not be hot reloaded.";
+    }
+
+    // --------- Telemetry --------- //
+    if (rf.check("telemetryPeriod"))
+    {
+        m_telemetry.setPeriod(rf.find("telemetryPeriod").asFloat64());
+    }
+    std::string telemetryFile = rf.check("telemetryFile") ? rf.find("telemetryFile").asString() : "";
+    std::size_t telemetryFileSize = rf.check("telemetryFileSize") ? static_cast<std::size_t>(rf.find("telemetryFileSize").asInt64()) : 1048576;
+    std::vector<std::string> telemetryCommands;
+    if (TourView tour = AcquireTour())
+    {
+        telemetryCommands = tour->getCommandNames();
+    }
+    if (!m_telemetry.Open("/" + m_name + "/telemetry:o", telemetryFile, telemetryFileSize, telemetryCommands) || !m_telemetry.start())
+    {
+        yCWarning(TOUR_MANAGER) << "Cannot start the telemetry. The timings will not be published.";
+    }
+
+    m_headSynchronizer.reset(); // Reset the status of the headSynchronizer for safety
+    TourView tour = AcquireTour();
+    if (tour && tour.languageSet)
+    {
+        PrepareSpeech(*tour.languageSet);
+    }
+    yCInfo(TOUR_MANAGER, "Configuration Done!");
+    return true;
+}
+
+bool TourManager::OpenNavigation(yarp::os::ResourceFinder &rf)
+{
     bool okNav = rf.check("NAVIGATION2D-CLIENT");
     std::string device = "navigation2D_nwc_yarp";
     std::string local = "/" + m_name + "/navClient";
@@ -174,17 +335,37 @@ bool TourManager::configure(yarp::os::ResourceFinder &rf)
         yCError(TOUR_MANAGER) << "Error opening iNav2D interface. Device not available";
         return false;
     }
-
-    m_headSynchronizer.reset(); // Reset the status of the headSynchronizer for safety
-    yCInfo(TOUR_MANAGER, "Configuration Done!");
+    m_nav2DNavigation = std::make_unique<Nav2DNavigation>(m_iNav2D);
+    m_navigation = m_nav2DNavigation.get();
     return true;
 }
 
+void TourManager::SetNavigation(NavigationInterface *navigation)
+{
+    m_navigation = navigation;
+}
+
 bool TourManager::close()
 {
+    m_commandExecutor.Stop();
+    m_jobPool.Stop(); // Before the navigation and the ports used by the jobs
+    m_telemetry.stop();
+    m_telemetry.Close(); // Publishes the timings of the last commands
+    m_contentReloader.stop();
+    m_navigationMonitor.stop();
+    m_locationCache.LogStatistics();
+    m_locationCache.Stop();
+    m_pSpeechStatus.close();
+    m_pSpeechEvents.close();
+    m_pLanguageOutput.close();
+    m_ctpDispatcher.LogStatistics();
+    m_ctpDispatcher.Stop(); // Before deleting the ports used by the workers
     m_pHeadSynchronizer.close();
     m_pDialogflowInput.close();
     delete m_dialogflowCallback;
+    m_pTranscriptionInput.close();
+    delete m_transcriptionCallback;
+    m_localIntents.LogStatistics();
     for (auto port : m_pCtpService)
     {
         delete &port.second;
@@ -209,49 +390,80 @@ bool TourManager::updateModule()
     return true;
 }
 
-bool TourManager::InterpretCommand(const std::string &command)
+std::shared_future<bool> TourManager::PostCommand(const std::string &command, CommandPriority priority)
 {
-    bool isOk = false;
-    std::vector<Action> actions;
-    std::string cmd;
-
-    bool isCurrent = m_currentPoI.isCommandValid(command);
-    bool isGeneric = m_genericPoI.isCommandValid(command);
+    bool isFallback = command.compare(0, 8, "fallback") == 0; // Every fallback counts towards the threshold, so they are never coalesced
+    return m_commandExecutor.Post(command, priority, !isFallback);
+}
 
-    if (isCurrent || isGeneric) // If the command is available either in the current PoI or the generic ones
+std::shared_future<bool> TourManager::OnTranscription(const std::string &text)
+{
+    std::string poiName = getCurrentPoIName();
+    std::string command;
+    if (m_localIntents.IsLoaded() && m_localIntents.Match(text, poiName, command))
     {
-        int cmd_multiples;
-        if (isCurrent) // If it is in the current overwrite the generic
+        return PostCommand(command, CommandPriority::DIALOG);
+    }
+    m_localIntents.OnForwarded();
+    SendToDialogue(text);
+    return std::shared_future<bool>();
+}
+
+std::shared_future<bool> TourManager::OnDialogResult(const std::string &command)
+{
+    m_localIntents.OnDialogResult();
+    return PostCommand(command, CommandPriority::DIALOG);
+}
+
+double TourManager::GetWaitTime() const
+{
+    return m_waitMicroseconds / 1e6;
+}
+
+bool TourManager::InterpretCommand(const std::string &command, const CancellationToken &token)
+{
+    Telemetry::ScopedTimer timer(m_telemetry.GetCommandHistogram(command));
+    if (command == REPEAT_SPEECH_COMMAND)
+    { // Said by the executor like the commands, so that only its thread speaks
+        std::string text;
         {
-            cmd_multiples = m_currentPoI.getCommandMultiplesNum(command);
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            text = m_interruptedSpeak;
         }
-        else
+        Speak(text, true);
+        BlockSpeak(token);
+        if (token.IsCancelled() && m_headSynchronizer.isSpeaking())
         {
-            cmd_multiples = m_genericPoI.getCommandMultiplesNum(command);
+            m_headSynchronizer.reset();
         }
+        return !token.IsCancelled();
+    }
+
+    TourView tour = AcquireTour(); // A reload during the command does not affect it, it keeps this model until it returns
+    const ActionPlan *plan = nullptr;
+    const std::string &cmd = command; // The variants share the behavior of their base command (e.g. fallback1 is a fallback)
+    CommandId commandId = tour->getCommandId(command);
+
+    bool isCurrent = tour.currentPoI && tour.currentPoI->isCommandValid(commandId);
+    const PoIView *genericPoI = tour.languageSet ? tour.languageSet->genericPoI : nullptr;
+    bool isGeneric = genericPoI && genericPoI->isCommandValid(commandId);
+
+    if (isCurrent || isGeneric) // If the command is available either in the current PoI or the generic ones
+    {
+        const PoIView *poi = isCurrent ? tour.currentPoI : genericPoI; // If it is in the current overwrite the generic
+        int cmd_multiples = poi->getVariantsNum(commandId);
+        int index = 0;
 
         if (cmd_multiples > 1)
         {
             m_uniform_distrib.param(std::uniform_int_distribution<std::mt19937::result_type>::param_type(1, cmd_multiples));
-            int index = m_uniform_distrib(m_random_gen) - 1;
-            cmd = command;
-            if (index != 0)
-            {
-                cmd = cmd.append(std::to_string(index));
-            }
-        }
-        else // The is only 1 command. It cannot be 0 because we checked if the command is available at the beginning
-        {
-            cmd = command;
+            index = m_uniform_distrib(m_random_gen) - 1;
         }
 
-        if (isCurrent)
+        plan = poi->getVariant(commandId, index);
+        if (!plan)
         {
-            isOk = m_currentPoI.getActions(cmd, actions);
-        }
-        else
-        {
-            isOk = m_genericPoI.getActions(cmd, actions);
+            yCError(TOUR_MANAGER) << "Command" << cmd << "not supported";
         }
     }
     else // Command is not available anywhere, return error and skip
@@ -259,74 +471,52 @@ bool TourManager::InterpretCommand(const std::string &command)
         yCWarning(TOUR_MANAGER) << "Command" << command << "not supported in either the PoI or the generics list. Skipping...";
     }
 
-    if (isOk && !actions.empty())
+    if (plan && !plan->empty())
     {
-        int actionIndex = 0;
-        bool isCommandBlocking = true;
-        Action lastNonSignalAction;
+        const std::vector<PlanStep> &steps = plan->getSteps();
+        bool isValidSpeak = cmd != "fallback" && cmd.find("Error") == std::string::npos; // Speak, but make it invalid if it is a fallback or it is an error message
 
-        while (actionIndex < actions.size())
+        for (const PlanGroup &group : plan->getGroups())
         {
-            std::vector<Action> tempActions;
-            for (int i = actionIndex; i < actions.size(); i++)
+            if (token.IsCancelled())
             {
-                tempActions.push_back(actions[i]);
-                if (actions[i].getType() != ActionTypes::SIGNAL)
-                {
-                    lastNonSignalAction = actions[i];
-                }
-                if (actions[i].isBlocking())
-                {
-                    actionIndex = i + 1;
-                    break;
-                }
-                else
-                {
-                    if (i == actions.size() - 1)
-                    {
-                        actionIndex = actions.size();
-                        if (!lastNonSignalAction.isBlocking())
-                        {
-                            isCommandBlocking = false;
-                        }
-                    }
-                }
+                break;
             }
-
             bool containsSpeak = false;
             float danceTime = 0.0f;
 
-            for (Action action : tempActions) // Loops through all the actions until the blocking one. Execute all of them
+            for (int i = group.begin; i < group.end; i++) // Loops through all the actions until the blocking one. Execute all of them
             {
-                switch (action.getType())
+                const PlanStep &step = steps[i];
+                switch (step.type)
                 {
                 case ActionTypes::SPEAK:
                 {
-                    // Speak, but make it invalid if it is a fallback or it is an error message
-                    Speak(action.getParam(), (cmd != "fallback" && cmd.find("Error") == std::string::npos));
+                    Speak(std::string(step.param), isValidSpeak);
                     containsSpeak = true;
                     break;
                 }
                 case ActionTypes::DANCE:
                 {
-                    danceTime += DoDance(action.getParam()); // By adding we can guarantee that if there multiple dances without blocking we can wait the max amount of time of them.
+                    DoDance(std::string(step.param));
+                    danceTime += step.danceDuration; // By adding we can guarantee that if there multiple dances without blocking we can wait the max amount of time of them.
                     break;
                 }
                 case ActionTypes::SIGNAL:
                 {
-                    Signal(action.getParam());
-                    bool isDelay = action.getParam().find("delay_") != std::string::npos;
+                    Signal(step.signal, token);
+                    bool isDelay = step.signal.type == SignalTypes::DELAY;
 
                     // Patch of code to handle a delay signal blocking the parallel execution
                     if (danceTime != 0.0f && isDelay)
                     {
-                        danceTime -= std::stof(action.getParam().substr(action.getParam().find("_") + 1, std::string::npos)); // Delay for the specified time in seconds.
+                        danceTime -= step.signal.delay;
                         if (danceTime < 0.0f)
                         {
                             danceTime = 0.0f;
                         }
                     }
-                    if (containsSpeak && !m_headSynchronizer.isSpeaking() && isDelay)
+                    if (containsSpeak && isDelay && !m_events.IsSpeaking())
                     {
                         containsSpeak = false;
                     }
@@ -345,30 +535,35 @@ bool TourManager::InterpretCommand(const std::string &command)
                 }
             }
 
-            if ((containsSpeak || danceTime != 0.0f) && isCommandBlocking) // Waits for the longest move in the temp list of blocked moves and speak. If there is nothing in the temp list because we are not blocking it is skipped.
+            if ((containsSpeak || danceTime != 0.0f) && group.isWaited) // Waits for the longest move in the group and speak. If the group is not waited because the command ends without blocking it is skipped.
             {
-                while (containsSpeak && !m_headSynchronizer.isSpeaking())
-                {
-                    yarp::os::Time::delay(0.1);
-                }
-                double startTime = yarp::os::Time::now();
-                while ((yarp::os::Time::now() - startTime) < danceTime)
-                {
-                    yarp::os::Time::delay(0.1);
-                }
-                while (m_headSynchronizer.isSpeaking())
+                if (danceTime > 0.0f)
                 {
-                    yarp::os::Time::delay(0.1);
+                    double danceStartTime = yarp::os::Time::now();
+                    WaitFor(danceTime, token);
+                    m_telemetry.Record(PoIMetric::DANCE, yarp::os::Time::now() - danceStartTime);
                 }
+                BlockSpeak(token);
             }
         }
 
+        if (token.IsCancelled())
+        { // Preempted by a command with a higher priority, which speaks right away
+            if (m_headSynchronizer.isSpeaking())
+            {
+                m_headSynchronizer.reset();
+            }
+            yCDebug(TOUR_MANAGER) << "Command" << command << "has been cancelled.";
+            return false;
+        }
+
         if (cmd == "fallback")
         {
+            m_telemetry.CountFallback();
             m_fallback_repeat_counter++;
             if (m_fallback_repeat_counter == m_fallback_threshold)
             { // If the same command has been received as many times as the threshold, then repeat the question.
-                Speak(m_last_valid_speak, true);
+                Speak(GetLastValidSpeak(), true);
                 BlockSpeak();
                 m_fallback_repeat_counter = 0;
             }
@@ -387,8 +582,11 @@ bool TourManager::NextPoI()
 {
     try
     {
-        m_PoIndex++;
-        m_PoIndex = m_PoIndex % m_tourStorage->GetTour().getPoIsList().size();
+        TourView tour = AcquireTour();
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            m_PoIndex = (tour.poiIndex + 1) % tour->getActivePoIs().size();
+        }
         return UpdatePoI();
     }
     catch (...)
@@ -400,20 +598,198 @@ bool TourManager::NextPoI()
 
 bool TourManager::UpdatePoI()
 {
-    bool b = m_tourStorage->GetTour().getPoI(m_tourStorage->GetTour().getPoIsList()[m_PoIndex], m_currentPoI); // Loads the next poi in the active pois specified in the tour object.
-    if (!b)
+    TourView tour = AcquireTour();
+    const PoIView *poi = tour.currentPoI; // Points to the next poi in the active pois specified in the tour object.
+    if (!poi)
     {
         yCError(TOUR_MANAGER) << "UpdatePoI failed to execute. Is the poi name in the active poi's?";
         return false;
     }
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_currentPoIName = poi->getName();
+    }
+    m_telemetry.SetPoI(poi->getName());
     yCDebug(TOUR_MANAGER) << "Updated PoI successfully.";
     return true;
 }
 
+bool TourManager::UpdateLanguage(const std::string &language)
+{
+    TourView tour = AcquireTour();
+    const LanguageSet *languageSet = tour->getLanguageSet(tour->getLanguageId(language));
+    if (!languageSet)
+    {
+        yCError(TOUR_MANAGER) << "The selected language is not supported:" << language;
+        return false;
+    }
+
+    if (!languageSet->genericPoI)
+    {
+        yCError(TOUR_MANAGER) << "Generic PoI not available for language:" << language;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex); // The PoIs of the language have been resolved when the tour was loaded
+        m_currentLanguageName = language;
+    }
+    m_localIntents.SetLanguage(*tour, *languageSet);
+    return UpdatePoI();
+}
+
+TourView TourManager::AcquireTour()
+{
+    TourView view;
+    view.tour = m_tourStorage->GetTourModel();
+    if (!view.tour)
+    {
+        return view;
+    }
+
+    // The position is resolved in the pinned model under the lock, so the pointers never outlive the model they point into
+    const TourModel &tour = *view.tour;
+    bool isReloaded = false;
+    std::string languageName;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        view.languageSet = tour.getLanguageSet(tour.getLanguageId(m_currentLanguageName));
+        if (view.tour.generation() != m_tourGeneration)
+        { // The tour has been reloaded: the current PoI has to be resolved again in the new model, by name
+            isReloaded = true;
+            m_tourGeneration = view.tour.generation();
+            const std::vector<PoIId> &activePoIs = tour.getActivePoIs();
+            auto currentPoI = std::find(activePoIs.begin(), activePoIs.end(), tour.getPoIId(m_currentPoIName));
+            if (currentPoI != activePoIs.end())
+            {
+                m_PoIndex = currentPoI - activePoIs.begin();
+            }
+            else if (static_cast<size_t>(m_PoIndex) >= activePoIs.size())
+            {
+                m_PoIndex = 0;
+            }
+        }
+        view.poiIndex = m_PoIndex;
+        view.currentPoI = view.languageSet ? tour.getActivePoI(view.languageSet->language, m_PoIndex) : nullptr;
+        if (isReloaded)
+        {
+            m_currentPoIName = view.currentPoI ? view.currentPoI->getName() : std::string();
+        }
+        languageName = m_currentLanguageName;
+    }
+    if (!isReloaded)
+    {
+        return view;
+    }
+
+    if (view.currentPoI)
+    {
+        m_telemetry.SetPoI(view.currentPoI->getName());
+    }
+    m_locationCache.SetNames(GetActivePoINames(tour)); // The new PoIs are resolved in background
+    if (languageName.empty())
+    {
+        return view; // No language selected yet, nothing was in use
+    }
+    if (!view.currentPoI || !view.languageSet->genericPoI)
+    {
+        yCWarning(TOUR_MANAGER) << "The reloaded tour does not contain the current PoI or language" << languageName;
+    }
+    else
+    {
+        yCDebug(TOUR_MANAGER) << "Switched to the reloaded tour. Current PoI:" << view.currentPoI->getName();
+        PrepareSpeech(*view.languageSet);
+        m_localIntents.SetLanguage(tour, *view.languageSet);
+    }
+    return view;
+}
+
+bool TourManager::SetServicesLanguage(const SignalCommand &signal)
+{
+    std::string language(signal.language);
+
+    // The three services are independent, so they are changed at the same time
+    std::future<bool> speechResult = std::async(std::launch::async, [this, &language]
+                                                { return m_speech.setLanguage(language); });
+    std::future<bool> dialogResult = std::async(std::launch::async, [this, &language]
+                                                { return m_Dialog.setLanguage(language); });
+    std::string debug_text = m_Synthesis.setLanguage(language, std::string(signal.voice));
+    if (!speechResult.get())
+    {
+        yCWarning(TOUR_MANAGER) << "googleSpeech failed to change language to" << language;
+    }
+    if (!dialogResult.get())
+    {
+        yCWarning(TOUR_MANAGER) << "googleDialog failed to change language to" << language;
+    }
+
+    // googleSynthesis applies the language before replying to setLanguage, so its reply is the notification of the change:
+    // the language is checked once instead of being polled
+    std::string languageCode = m_Synthesis.getLanguageCode();
+    if (languageCode != language)
+    {
+        yCError(TOUR_MANAGER) << "Language failed to change in google. The synthesis is in" << languageCode << ":" << debug_text;
+        return false;
+    }
+
+    yarp::os::Bottle &notification = m_pLanguageOutput.prepare();
+    notification.clear();
+    notification.addString(language);
+    notification.addString(std::string(signal.voice));
+    m_pLanguageOutput.writeStrict(); // Every change is notified, none is overwritten by the next one
+    return true;
+}
+
+std::vector<std::string> TourManager::GetActivePoINames(const TourModel &tour) const
+{
+    std::vector<std::string> names;
+    names.reserve(tour.getActivePoIs().size());
+    for (PoIId poi : tour.getActivePoIs())
+    {
+        names.push_back(tour.getPoIName(poi));
+    }
+    return names;
+}
+
+void TourManager::PrepareSpeech(const LanguageSet &languageSet)
+{
+    // The texts of the tour are synthesized in advance by the headSynchronizer, in the order of the tour, and then played from its speech clip store
+    std::vector<std::string> texts;
+    std::unordered_set<std::string_view> isAdded; // The texts are pooled in the tour model, which is pinned by the caller
+    std::vector<const PoIView *> pois = languageSet.activePoIs;
+    pois.push_back(languageSet.genericPoI);
+    for (const PoIView *poi : pois)
+    {
+        if (!poi)
+        {
+            continue;
+        }
+        for (const ActionPlan &plan : poi->getPlans())
+        {
+            for (const PlanStep &step : plan.getSteps())
+            {
+                if (step.type == ActionTypes::SPEAK && isAdded.insert(step.param).second)
+                {
+                    texts.emplace_back(step.param);
+                }
+            }
+        }
+    }
+    if (!m_headSynchronizer.prepareSpeech(texts))
+    {
+        yCDebug(TOUR_MANAGER) << "The headSynchronizer does not prepare the speech in advance.";
+    }
+}
+
 void TourManager::Speak(const std::string &text, bool isValid)
 {
-    if (m_headSynchronizer.say(text))
+    std::int64_t utterance = m_headSynchronizer.sayUtterance(text);
+    if (utterance > 0)
     {
+        m_lastUtterance = utterance;
+        m_events.SetSpeaking(true); // The headSynchronizer is speaking as soon as the text is queued
+        double noSpeakTime = -1.0;
+        m_speakTime.compare_exchange_strong(noSpeakTime, yarp::os::Time::now()); // Only the first text of a group starts the speech
         yCDebug(TOUR_MANAGER) << "I am playing:" << text;
     }
     else
@@ -422,94 +798,99 @@ void TourManager::Speak(const std::string &text, bool isValid)
     }
     if (isValid)
     {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
         m_last_valid_speak = text;
     }
 }
 
+std::string TourManager::GetLastValidSpeak()
+{
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    return m_last_valid_speak;
+}
+
+std::shared_future<bool> TourManager::RepeatSpeech(const std::string &text)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_interruptedSpeak = text;
+    }
+    return m_commandExecutor.Post(REPEAT_SPEECH_COMMAND, CommandPriority::IDLE);
+}
+
 float TourManager::DoDance(const std::string &danceName)
 {
-    Dance currentDance;
-    if (!m_moveStorage->GetMovementsContainer().GetDance(danceName, currentDance))
+    MovementStorage::ContainerGuard movements = m_moveStorage->GetMovementsContainer();
+    const Dance *currentDance = movements ? movements->FindDance(danceName) : nullptr;
+    if (!currentDance)
     {
         yCWarning(TOUR_MANAGER) << "Dance" << danceName << "not found. Skipping...";
         return 0.0f;
     }
 
-    bool status;
-    for (Movement currentMove : currentDance.GetMovements())
+    // The movements are queued to the worker of their part, so all the parts start together
+    std::shared_ptr<CtpDispatcher::Batch> batch = std::make_shared<CtpDispatcher::Batch>(danceName);
+    for (const Movement &currentMove : currentDance->GetMovements())
     {
-        if (!m_moveStorage->GetMovementsContainer().GetPartNames().count(currentMove.GetPartName()))
+        if (!movements->GetPartNames().count(currentMove.GetPartName()) || !m_ctpDispatcher.HasPart(currentMove.GetPartName()))
         {
             yCWarning(TOUR_MANAGER) << "Part" << currentMove.GetPartName() << "not supported. Skipping...";
             continue;
         }
-
-        yarp::os::Port &port = m_pCtpService.at(currentMove.GetPartName());
-        status = SendMovement(currentMove.GetTime(), currentMove.GetOffset(), currentMove.GetJoints(), port);
-        if (!status)
-        {
-            yCError(TOUR_MANAGER) << "Movement failed to sent. Is ctpService for part" << currentMove.GetPartName() << "running?";
-            continue;
-        }
+        m_ctpDispatcher.Dispatch(currentMove.GetPartName(), currentMove.GetCommand(), batch); // The command has been encoded when the movements were loaded
     }
-    yCDebug(TOUR_MANAGER) << "I danced:" << danceName << "with duration:" << currentDance.GetDuration();
-    return currentDance.GetDuration();
+    m_ctpDispatcher.Seal(batch);
+    yCDebug(TOUR_MANAGER) << "I danced:" << danceName << "with duration:" << currentDance->GetDuration();
+    return currentDance->GetDuration();
 }
 
 void TourManager::Signal(const std::string &param)
 {
-    if (param == "startHearing")
+    Signal(SignalCommand::Parse(param));
+}
+
+void TourManager::Signal(const SignalCommand &signal, const CancellationToken &token)
+{
+    switch (signal.type)
+    {
+    case SignalTypes::START_HEARING:
     {
         m_headSynchronizer.startHearing(); // Open the microphone and listen
         yCDebug(TOUR_MANAGER) << "I started hearing.";
+        break;
     }
-    else if (param.find("setLanguage") != std::string::npos)
+    case SignalTypes::SET_LANGUAGE:
     { // Change the language to the specified one
-        std::string voice = param.substr(param.find("_") + 1, std::string::npos);
-        std::string language = voice.substr(0, voice.find("-", 4)); // Get a copy of the language part of the string after the first delimiter
-
-        if (voice.empty() || language.empty())
+        std::string language(signal.language);
+        if (!SetServicesLanguage(signal))
         {
-            yCError(TOUR_MANAGER) << "Failed to change language. Voice and language is empty";
             return;
         }
-
-        m_speech.setLanguage(language);
-        m_Dialog.setLanguage(language);
-        std::string debug_text = m_Synthesis.setLanguage(language, voice);
-
-        double startTime = yarp::os::Time::now();
-        while (m_Synthesis.getLanguageCode() != language)
+        if (!UpdateLanguage(language))
         {
-            // Setting timeout of change language to 5 seconds
-            if ((yarp::os::Time::now() - startTime) >= 5.0)
-            {
-                yCError(TOUR_MANAGER) << "Language failed to change in google and timed out." << debug_text;
-                return;
-            }
-            yarp::os::Time::delay(0.1);
-        }
-        if (!m_tourStorage->GetTour().setCurrentLanguage(language))
-        {
-            yCError(TOUR_MANAGER) << "Language failed to change in TourStorage and timed out.";
+            yCError(TOUR_MANAGER) << "Language failed to change in the tour model.";
             return;
         }
-        yCDebug(TOUR_MANAGER) << "Changed language successfully to:" << language;
-        if (!m_tourStorage->GetTour().getPoI("___generic___", m_genericPoI))
+        TourView tour = AcquireTour();
+        if (tour.languageSet)
         {
-            yCError(TOUR_MANAGER) << "Generic PoI failed update after changing language.";
-            return;
+            PrepareSpeech(*tour.languageSet);
         }
-        UpdatePoI();
+        yCDebug(TOUR_MANAGER) << "Changed language successfully to:" << language;
+        break;
     }
-    else if (param == "nextPoi") // Received by googleDialog
+    case SignalTypes::NEXT_POI: // Received by googleDialog
     {
         NextPoI();
+        break;
     }
-    else if (param == "reset")
+    case SignalTypes::RESET:
     {
-        m_PoIndex = 0;
-        if (m_currentPoI.getName().find("_start") == std::string::npos)
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            m_PoIndex = 0;
+        }
+        if (getCurrentPoIName().find("_start") == std::string::npos)
         {
             m_isFirstStart = true;
         }
@@ -518,33 +899,39 @@ void TourManager::Signal(const std::string &param)
         UpdatePoI();
         Signal("startHearing");
         yCDebug(TOUR_MANAGER) << "Reset TourManager and HeadSynchronizer successfully.";
+        break;
     }
-    else if (param.find("delay_") != std::string::npos)
+    case SignalTypes::DELAY:
     {
-        float delay = std::stof(param.substr(param.find("_") + 1, std::string::npos)); // Delay for the specified time in seconds.
-        yCDebug(TOUR_MANAGER) << "I am delaying for:" << delay << "seconds.";
-        yarp::os::Time::delay(delay);
+        yCDebug(TOUR_MANAGER) << "I am delaying for:" << signal.delay << "seconds.";
+        WaitFor(signal.delay, token);
+        break;
     }
-    else
+    default:
     {
-        yCError(TOUR_MANAGER) << "Received an empty signal. That should never happen!";
+        yCError(TOUR_MANAGER) << "Received an invalid signal. That should never happen!";
+        break;
+    }
     }
 }
 
 bool TourManager::recovered()
 {
+    double errorTime = m_errorTime.exchange(-1.0);
+    if (errorTime >= 0.0)
+    {
+        m_telemetry.Record(PoIMetric::ERROR_RECOVERY, yarp::os::Time::now() - errorTime);
+    }
     m_headSynchronizer.reset();
-    yarp::dev::Nav2D::NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navigationMonitor.Refresh(); // The status is not polled between the navigations
+    yarp::dev::Nav2D::NavigationStatusEnum currentStatus = m_events.GetNavigationStatus();
 
     // If it was speaking and the robot is not about to move again
     if (currentStatus == yarp::dev::Nav2D::navigation_status_goal_reached)
     {
-        if (m_isSpeechInterrupted)
+        if (m_isSpeechInterrupted.exchange(false))
         {
-            Speak(m_last_valid_speak, true);
-            BlockSpeak();
-            m_isSpeechInterrupted = false;
+            RepeatSpeech(GetLastValidSpeak()).wait(); // Heard only once the sentence has been said again
         }
         // Start hearing only if the robot will not move. Otherwise it is expected to speak
         m_headSynchronizer.startHearing();
@@ -556,12 +943,14 @@ bool TourManager::recovered()
 bool TourManager::sendError(const std::string &error)
 {
     yCError(TOUR_MANAGER) << "Received error:" << error;
+    double noErrorTime = -1.0;
+    m_errorTime.compare_exchange_strong(noErrorTime, yarp::os::Time::now()); // The recovery time covers all the errors until recovered
 
-    yarp::dev::Nav2D::NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
-    if (currentStatus != yarp::dev::Nav2D::navigation_status_idle || currentStatus != yarp::dev::Nav2D::navigation_status_goal_reached || currentStatus != yarp::dev::Nav2D::navigation_status_aborted)
+    m_navigationMonitor.Refresh(); // The status is not polled between the navigations
+    yarp::dev::Nav2D::NavigationStatusEnum currentStatus = m_events.GetNavigationStatus();
+    if (currentStatus != yarp::dev::Nav2D::navigation_status_idle && currentStatus != yarp::dev::Nav2D::navigation_status_goal_reached && currentStatus != yarp::dev::Nav2D::navigation_status_aborted)
     {
-        m_iNav2D->stopNavigation(); // Can only stop navigation goals that have been sent by YARP. Can't stop override commands from rviz
+        m_navigation->stopNavigation(); // Can only stop navigation goals that have been sent by YARP. Can't stop override commands from rviz
     }
 
     if (m_headSynchronizer.isSpeaking())
@@ -570,25 +959,26 @@ bool TourManager::sendError(const std::string &error)
         m_isSpeechInterrupted = true;
     }
 
+    // The errors are said by the command executor, which preempts the running command. The RPC waits for them as they are re-sent until recovered
     if (error == "NETWORK_ERROR")
     {
-        InterpretCommand("networkError");
+        m_commandExecutor.Execute("networkError", CommandPriority::ERROR);
     }
     else if (error == "MOTORS_ERROR")
     {
-        InterpretCommand("motorsError");
+        m_commandExecutor.Execute("motorsError", CommandPriority::ERROR);
     }
     else if (error == "TOUCHED_ERROR")
     {
-        InterpretCommand("touchedError");
+        m_commandExecutor.Execute("touchedError", CommandPriority::ERROR);
     }
     else if (error == "LOCALIZATION_ERROR")
     {
-        InterpretCommand("localizationError");
+        m_commandExecutor.Execute("localizationError", CommandPriority::ERROR);
     }
     else if (error == "GOAL_ERROR")
     {
-        InterpretCommand("goalNotAvailableError");
+        m_commandExecutor.Execute("goalNotAvailableError", CommandPriority::ERROR);
     }
     else
     {
@@ -599,10 +989,58 @@ bool TourManager::sendError(const std::string &error)
     return true;
 }
 
+bool TourManager::StartNavigation(const std::string &poiName, const CancellationToken &token)
+{
+    // Set to navigation position
+    float duration = DoDance("navigationPosition");
+    double poseReachedTime = yarp::os::Time::now() + duration;
+
+    bool isPipelined = m_isTransitionPipelined;
+    bool isHeld = false;
+    if (isPipelined && m_isPoseInterlocked && duration > 0.0f)
+    { // The base is held before the goal is sent, so that it never moves with the arms out of pose
+        isHeld = m_navigation->suspendNavigation(duration); // Released automatically after the duration if the resume below is lost
+        if (!isHeld)
+        {
+            yCWarning(TOUR_MANAGER) << "Cannot hold the base before sending the goal. Waiting for the navigation pose before sending the goal.";
+            isPipelined = false;
+        }
+    }
+
+    if (isPipelined)
+    { // The path is planned while the arms move to the navigation pose
+        m_navigation->gotoTargetByLocationName(poiName);
+    }
+
+    if (!isPipelined || isHeld)
+    { // Wait for the navigation dance to finish executing
+        if (!WaitFor(std::max(0.0, poseReachedTime - yarp::os::Time::now()), token))
+        {
+            if (isPipelined)
+            {
+                m_navigation->stopNavigation(); // Drops the held goal
+            }
+            return false;
+        }
+    }
+
+    if (!isPipelined)
+    {
+        m_navigation->gotoTargetByLocationName(poiName);
+    }
+    else if (isHeld)
+    {
+        m_navigation->resumeNavigation();
+    }
+    yCDebug(TOUR_MANAGER) << "Moving to next PoI:" << poiName;
+    return true;
+}
+
 bool TourManager::isAtPoI()
 {
     // Check if hasReachedPoI so that we can override manually without depending on the navigation status
-    if (m_hasReachedPoI && m_currentPoI.getName() == m_previousPoIname)
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    if (m_hasReachedPoI && m_currentPoIName == m_previousPoIname)
     {
         return true;
     }
@@ -611,91 +1049,137 @@ bool TourManager::isAtPoI()
 
 bool TourManager::sendToPoI()
 {
-    m_hasReachedPoI = false;
+    std::lock_guard<std::mutex> lock(m_navigationMutex);
+    return NavigateToPoI(CancellationToken());
+}
+
+std::int32_t TourManager::sendToPoIAsync()
+{
+    return m_jobPool.Submit("sendToPoI", [this](const CancellationToken &token)
+                            {
+                                std::lock_guard<std::mutex> lock(m_navigationMutex);
+                                {
+                                    std::lock_guard<std::mutex> ownerLock(m_navigationOwnerMutex);
+                                    m_navigationOwner = token;
+                                }
+                                bool result = !token.IsCancelled() && NavigateToPoI(token);
+                                {
+                                    std::lock_guard<std::mutex> ownerLock(m_navigationOwnerMutex);
+                                    m_navigationOwner = CancellationToken();
+                                }
+                                return result; });
+}
+
+std::string TourManager::getJobStatus(const std::int32_t jobId)
+{
+    return JobPool::ToString(m_jobPool.GetStatus(jobId));
+}
+
+bool TourManager::cancelJob(const std::int32_t jobId)
+{
+    CancellationToken token;
+    if (!m_jobPool.Cancel(jobId, &token))
+    {
+        yCWarning(TOUR_MANAGER) << "Cannot cancel the job" << jobId << ": it does not exist or it has already ended";
+        return false;
+    }
+
+    // The navigation is stopped only if it still belongs to the cancelled job, never the one of the next navigation
+    std::lock_guard<std::mutex> lock(m_navigationOwnerMutex);
+    if (token.IsSameAs(m_navigationOwner))
+    {
+        m_navigation->stopNavigation(); // Wakes up the navigation waits of the job
+    }
+    return true;
+}
+
+bool TourManager::NavigateToPoI(const CancellationToken &token)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_hasReachedPoI = false;
+    }
 
     yarp::dev::Nav2D::Map2DLocation current_target_coord;
-    if (!m_iNav2D->getLocation(m_currentPoI.getName(), current_target_coord))
+    if (!m_locationCache.Get(getCurrentPoIName(), current_target_coord))
     {
-        yCError(TOUR_MANAGER) << "Could not get next location coordinates for PoI" << m_currentPoI.getName();
+        yCError(TOUR_MANAGER) << "Could not get next location coordinates for PoI" << getCurrentPoIName();
         return false;
     }
 
     bool isDifferentPoI = current_target_coord != m_previousPoIloc;
     if (isDifferentPoI)
     {
-        std::string validSpeakTmp = m_last_valid_speak;
+        std::string validSpeakTmp = GetLastValidSpeak();
         // if the poi is at different coordinates, move. Else skip.
         if (!m_isFirstStart)
-        {
-            InterpretCommand("warningNextNavigation");
+        { // Said before the arms and the base move. With the priority of the errors, no dialog command preempts it
+            m_commandExecutor.Execute("warningNextNavigation", CommandPriority::ERROR);
         }
 
-        // Set to navigation position
-        float duration = DoDance("navigationPosition");
-
-        // Wait for the navigation dance to finish executing
-        double startTime = yarp::os::Time::now();
-        while ((yarp::os::Time::now() - startTime) < duration)
+        NavigationMonitor::ActiveScope monitoring(m_navigationMonitor); // The navigation status is polled until the PoI is reached or the navigation fails
+        double navigationStartTime = yarp::os::Time::now();
+        if (!StartNavigation(getCurrentPoIName(), token) || token.IsCancelled())
         {
-            yarp::os::Time::delay(0.1);
+            m_navigation->stopNavigation();
+            yCInfo(TOUR_MANAGER) << "The navigation to" << getCurrentPoIName() << "has been cancelled.";
+            return false;
         }
 
-        m_iNav2D->gotoTargetByLocationName(m_currentPoI.getName());
-        yCDebug(TOUR_MANAGER) << "Moving to next PoI:" << m_currentPoI.getName();
-
+        // Setting timeout of navigation status change to 2 seconds
         yarp::dev::Nav2D::NavigationStatusEnum currentStatus;
-        m_iNav2D->getNavigationStatus(currentStatus);
-        startTime = yarp::os::Time::now();
-        while (currentStatus != yarp::dev::Nav2D::navigation_status_moving)
+        if (!m_events.WaitNavigationStatus({yarp::dev::Nav2D::navigation_status_moving}, 2.0, currentStatus))
         {
-            // Setting timeout of navigation status change to 2 seconds
-            if ((yarp::os::Time::now() - startTime) >= 2.0)
-            {
-                yCError(TOUR_MANAGER) << "Navigation command failed to reach move_base and timed out.";
-                return false;
-            }
-            m_iNav2D->getNavigationStatus(currentStatus);
-            yarp::os::Time::delay(0.1);
+            yCError(TOUR_MANAGER) << "Navigation command failed to reach move_base and timed out.";
+            return false;
         }
 
         // If it was interrupted during previous navigation, only repeat the last sentence that is relevant
-        if (m_isSpeechInterrupted)
+        if (m_isSpeechInterrupted.exchange(false))
         {
-            Speak(validSpeakTmp, true);
-            BlockSpeak();
-            m_isSpeechInterrupted = false;
+            RepeatSpeech(validSpeakTmp); // Never waited, the navigation goes on while it is said
         }
         else
         {
-            InterpretCommand("sayWhileNavigating");
+            m_commandExecutor.Post("sayWhileNavigating", CommandPriority::IDLE); // Never waited, the navigation goes on while it is said
         }
         m_headSynchronizer.happyFace();
 
-        while (currentStatus != yarp::dev::Nav2D::navigation_status_goal_reached)
+        m_events.WaitNavigationStatus({yarp::dev::Nav2D::navigation_status_goal_reached, yarp::dev::Nav2D::navigation_status_aborted, yarp::dev::Nav2D::navigation_status_idle}, -1.0, currentStatus);
+        if (currentStatus == yarp::dev::Nav2D::navigation_status_aborted)
         {
-            m_iNav2D->getNavigationStatus(currentStatus);
-            if (currentStatus == yarp::dev::Nav2D::navigation_status_aborted)
-            {
-                if (m_headSynchronizer.isSpeaking())
-                {
-                    m_headSynchronizer.reset();
-                }
-                InterpretCommand("navigationError");
-                m_headSynchronizer.sadFaceWarning();
-                return false;
-            }
-            else if (currentStatus == yarp::dev::Nav2D::navigation_status_idle)
+            m_locationCache.Invalidate(getCurrentPoIName()); // The location could have been changed on the map server, it is resolved again on the next attempt
+            if (m_headSynchronizer.isSpeaking())
             {
-                return false;
+                m_headSynchronizer.reset();
             }
-            yarp::os::Time::delay(0.1);
+            m_commandExecutor.Execute("navigationError", CommandPriority::ERROR);
+            m_headSynchronizer.sadFaceWarning();
+            return false;
+        }
+        else if (currentStatus == yarp::dev::Nav2D::navigation_status_idle)
+        {
+            return false;
         }
+        m_telemetry.Record(PoIMetric::NAVIGATION, yarp::os::Time::now() - navigationStartTime);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_hasReachedPoI = true;
+        m_previousPoIname = m_currentPoIName; // Name is unique on every PoI
     }
-    m_hasReachedPoI = true;
-    m_previousPoIname = m_currentPoI.getName(); // Name is unique on every PoI
     m_previousPoIloc = current_target_coord;    // Coordinates of two pois can be the same. This is only used when we have two consecutive poi's on same location to skip movement
 
-    if (m_currentPoI.getName().find("_start") != std::string::npos)
+    if (TourView tour = AcquireTour())
+    { // The next PoI is resolved while the current one is being presented
+        const std::vector<PoIId> &activePoIs = tour->getActivePoIs();
+        if (!activePoIs.empty())
+        {
+            m_locationCache.Prefetch(tour->getPoIName(activePoIs[(tour.poiIndex + 1) % activePoIs.size()]));
+        }
+    }
+
+    if (getCurrentPoIName().find("_start") != std::string::npos)
     {
         Signal(m_defaultLanguage);
         if (!m_isFirstStart)
@@ -716,21 +1200,78 @@ bool TourManager::sendToPoI()
     return true;
 }
 
-void TourManager::BlockSpeak()
+void TourManager::BlockSpeak(const CancellationToken &token)
 {
-    while (!m_headSynchronizer.isSpeaking())
+    // Woken up by the end of the last text said, or by the speech status events of the headSynchronizer. Without them it falls back to polling
+    std::int64_t utterance = m_lastUtterance.load();
+    bool isUtteranceWaited = utterance > 0 && m_events.HasUtteranceEvents();
+    double timeout = isUtteranceWaited || m_events.HasSpeechEvents() ? 1.0 : 0.1;
+    double startTime = yarp::os::Time::now();
+    double lastCheck = startTime;
+    while (!token.IsCancelled())
     {
-        yarp::os::Time::delay(0.1);
+        double slice = std::min(timeout, m_commandTick); // Sliced to notice the cancellation within a tick
+        bool isIdle = isUtteranceWaited ? m_events.WaitUtterance(utterance, slice) : m_events.WaitSpeechIdle(slice);
+        if (isIdle && isUtteranceWaited)
+        { // The event of the last text said cannot be older than the say
+            m_events.SetSpeaking(false);
+            break;
+        }
+        if (!isIdle && yarp::os::Time::now() - lastCheck < timeout)
+        {
+            continue;
+        }
+        lastCheck = yarp::os::Time::now();
+        isIdle = isUtteranceWaited ? m_headSynchronizer.waitForUtterance(utterance, 0.0) : !m_headSynchronizer.isSpeaking();
+        if (isIdle) // A single check confirms the event, which could be older than the last say, or covers the lost events
+        {
+            m_events.SetSpeaking(false);
+            break;
+        }
+        m_events.SetSpeaking(true);
     }
-    while (m_headSynchronizer.isSpeaking())
+    double endTime = yarp::os::Time::now();
+    m_waitMicroseconds += static_cast<std::int64_t>((endTime - startTime) * 1e6);
+
+    double speakTime = m_speakTime.exchange(-1.0);
+    if (speakTime >= 0.0)
     {
-        yarp::os::Time::delay(0.1);
+        double speechStartTime = m_events.GetSpeechStartTime();
+        if (speechStartTime >= speakTime) // Only known with the speech status events of the headSynchronizer
+        {
+            m_telemetry.Record(PoIMetric::SPEECH_START, speechStartTime - speakTime);
+            speakTime = speechStartTime;
+        }
+        m_telemetry.Record(PoIMetric::SPEAKING, endTime - speakTime);
     }
 }
 
+bool TourManager::WaitFor(double duration, const CancellationToken &token)
+{
+    double startTime = yarp::os::Time::now();
+    double endTime = startTime + duration;
+    for (double remaining = duration; remaining > 0.0; remaining = endTime - yarp::os::Time::now())
+    {
+        if (token.IsCancelled())
+        {
+            break;
+        }
+        yarp::os::Time::delay(std::min(remaining, m_commandTick));
+    }
+    m_waitMicroseconds += static_cast<std::int64_t>((yarp::os::Time::now() - startTime) * 1e6);
+    return !token.IsCancelled();
+}
+
 std::string TourManager::getCurrentPoIName()
 {
-    return m_currentPoI.getName();
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    return m_currentPoIName;
+}
+
+bool TourManager::reloadContent()
+{
+    yCInfo(TOUR_MANAGER) << "Reloading the tour and the movements...";
+    return m_contentReloader.Reload(m_reloadTimeout);
 }
 
 void TourManager::SendToDialogue(const std::string &command)
@@ -741,29 +1282,20 @@ void TourManager::SendToDialogue(const std::string &command)
     yCDebug(TOUR_MANAGER) << "I am sending to dialogueFlow:" << command;
 }
 
-bool TourManager::SendMovement(float time, float offset, std::vector<float> joints, yarp::os::Port &port)
+DialogflowCallback::DialogflowCallback(TourManager *tourManager) : m_tourManager(tourManager)
 {
-    yarp::os::Bottle res;
-    yarp::os::Bottle cmd;
-    cmd.addVocab32("ctpq");
-    cmd.addVocab32("time");
-    cmd.addFloat64(time);
-    cmd.addVocab32("off");
-    cmd.addFloat64(offset);
-    cmd.addVocab32("pos");
-    yarp::os::Bottle &list = cmd.addList();
-    for (auto joint : joints)
-    {
-        list.addFloat64(joint);
-    }
-    return port.write(cmd, res);
 }
 
-DialogflowCallback::DialogflowCallback(TourManager *tourManager) : m_tourManager(tourManager)
+void DialogflowCallback::onRead(yarp::os::Bottle &b)
 {
+    m_tourManager->OnDialogResult(b.toString()); // Never blocks the port, the commands are executed in order by the executor
 }
 
-void DialogflowCallback::onRead(yarp::os::Bottle &b)
+TranscriptionCallback::TranscriptionCallback(TourManager *tourManager) : m_tourManager(tourManager)
+{
+}
+
+void TranscriptionCallback::onRead(yarp::os::Bottle &b)
 {
-    m_tourManager->InterpretCommand(b.toString());
+    m_tourManager->OnTranscription(b.get(0).asString());
 }
@@ -0,0 +1,289 @@
+#include "tourModel.h"
+#include <map>
+
+YARP_LOG_COMPONENT(TOUR_MODEL, "behavior_tour_robot.aux_modules.TourManager.TourModel", yarp::os::Log::TraceType)
+
+/**
+ *
+ * START OF POI_VIEW
+ *
+ */
+
+PoIId PoIView::getId() const
+{
+    return m_id;
+}
+
+const std::string &PoIView::getName() const
+{
+    return m_model->getPoIName(m_id);
+}
+
+bool PoIView::isCommandValid(CommandId command) const
+{
+    return command >= 0 && static_cast<size_t>(command) < m_variants.size() && m_variants[command].count > 0;
+}
+
+bool PoIView::isCommandValid(const std::string &command) const
+{
+    return isCommandValid(m_model->getCommandId(command));
+}
+
+const ActionPlan *PoIView::getPlan(CommandId command) const
+{
+    return getVariant(command, 0); // The first variant is always the command itself
+}
+
+const ActionPlan *PoIView::getPlan(const std::string &command) const
+{
+    return getPlan(m_model->getCommandId(command));
+}
+
+int PoIView::getVariantsNum(CommandId command) const
+{
+    return isCommandValid(command) ? m_variants[command].count : 0;
+}
+
+const ActionPlan *PoIView::getVariant(CommandId command, int variant) const
+{
+    if (variant < 0 || variant >= getVariantsNum(command))
+    {
+        return nullptr;
+    }
+    return &m_plans[m_variantPlans[m_variants[command].begin + variant]];
+}
+
+const std::vector<ActionPlan> &PoIView::getPlans() const
+{
+    return m_plans;
+}
+
+/**
+ *
+ * END OF POI_VIEW
+ *
+ */
+
+/**
+ *
+ * START OF TOUR_MODEL
+ *
+ */
+
+TourModel::TourModel(const Tour &tour, const MovementsContainer *movements)
+{
+    for (const std::string &poiName : tour.getPoIsList())
+    {
+        m_activePoIs.push_back(internPoI(poiName));
+    }
+    m_genericPoI = internPoI(GENERIC_POI_NAME);
+
+    for (const auto &language : tour.getAvailablePoIs())
+    {
+        m_languageIds.insert({language.first, static_cast<LanguageId>(m_languages.size())});
+        m_languages.push_back(language.first);
+        m_pois.emplace_back();
+
+        for (const auto &poi : language.second)
+        {
+            PoIId poiId = internPoI(poi.first);
+            std::vector<PoIView> &languagePoIs = m_pois.back();
+            if (languagePoIs.size() <= static_cast<size_t>(poiId))
+            {
+                languagePoIs.resize(poiId + 1);
+            }
+
+            PoIView &view = languagePoIs[poiId];
+            view.m_id = poiId;
+            buildView(view, poi.second, movements);
+        }
+    }
+
+    // Every language gets a slot for every PoI so that lookups by id are always in range
+    for (std::vector<PoIView> &languagePoIs : m_pois)
+    {
+        languagePoIs.resize(m_poiNames.size());
+        for (PoIView &view : languagePoIs)
+        {
+            view.m_model = this;
+            view.m_variants.resize(m_commandNames.size());
+        }
+    }
+
+    m_languageSets.resize(m_languages.size());
+    for (LanguageId lang = 0; lang < static_cast<LanguageId>(m_languages.size()); lang++)
+    {
+        LanguageSet &set = m_languageSets[lang];
+        set.language = lang;
+        set.genericPoI = getGenericPoI(lang);
+        for (PoIId poi : m_activePoIs)
+        {
+            set.activePoIs.push_back(getPoI(lang, poi));
+        }
+    }
+
+    yCInfo(TOUR_MODEL) << "Interned" << m_languages.size() << "languages," << m_poiNames.size() << "PoIs and" << m_commandNames.size() << "commands.";
+    m_strings.Seal(); // The model is immutable from now on
+    StringPool::Statistics strings = m_strings.GetStatistics();
+    yCInfo(TOUR_MODEL) << "Pooled" << strings.interned << "action parameters as" << strings.unique << "unique strings in" << strings.poolBytes
+                       << "bytes instead of" << strings.separateBytes << "bytes, saving"
+                       << static_cast<long long>(strings.separateBytes) - static_cast<long long>(strings.poolBytes) << "bytes.";
+}
+
+void TourModel::buildView(PoIView &view, const PoI &poi, const MovementsContainer *movements)
+{
+    const std::unordered_map<std::string, std::vector<Action>> &commands = poi.getAvailableActions();
+
+    // A variant is named as its base command followed by a numeric suffix, and is only a variant if the base command exists too.
+    // Every command is also its own variant 0, so that it can always be requested by its full name.
+    std::map<std::string, std::map<long, int>> variants; // Base command -> suffix -> index of the plan
+    for (const auto &command : commands)
+    {
+        int planIndex = static_cast<int>(view.m_plans.size());
+        view.m_plans.emplace_back(command.second, movements, m_strings);
+        variants[command.first].insert({0, planIndex});
+
+        size_t suffixBegin = command.first.find_last_not_of("0123456789") + 1;
+        if (suffixBegin == 0 || suffixBegin == command.first.size() || command.first.size() - suffixBegin > 9)
+        {
+            continue; // No base name or no suffix (or a suffix too long to be an index)
+        }
+        std::string base = command.first.substr(0, suffixBegin);
+        if (commands.count(base) > 0)
+        {
+            variants[base].insert({std::stol(command.first.substr(suffixBegin)), planIndex});
+        }
+    }
+
+    for (const auto &command : variants)
+    {
+        CommandId id = internCommand(command.first);
+        if (view.m_variants.size() <= static_cast<size_t>(id))
+        {
+            view.m_variants.resize(id + 1);
+        }
+        view.m_variants[id] = {static_cast<int>(view.m_variantPlans.size()), static_cast<int>(command.second.size())};
+        for (const auto &variant : command.second)
+        {
+            view.m_variantPlans.push_back(variant.second);
+        }
+    }
+}
+
+PoIId TourModel::internPoI(const std::string &poiName)
+{
+    auto found = m_poiIds.find(poiName);
+    if (found != m_poiIds.end())
+    {
+        return found->second;
+    }
+    PoIId id = static_cast<PoIId>(m_poiNames.size());
+    m_poiNames.push_back(poiName);
+    m_poiIds.insert({poiName, id});
+    return id;
+}
+
+CommandId TourModel::internCommand(const std::string &command)
+{
+    auto found = m_commandIds.find(command);
+    if (found != m_commandIds.end())
+    {
+        return found->second;
+    }
+    CommandId id = static_cast<CommandId>(m_commandNames.size());
+    m_commandNames.push_back(command);
+    m_commandIds.insert({command, id});
+    return id;
+}
+
+LanguageId TourModel::getLanguageId(const std::string &lang) const
+{
+    auto found = m_languageIds.find(lang);
+    return found != m_languageIds.end() ? found->second : INVALID_ID;
+}
+
+const std::string &TourModel::getLanguageName(LanguageId lang) const
+{
+    return m_languages.at(lang);
+}
+
+const std::vector<std::string> &TourModel::getAvailableLanguages() const
+{
+    return m_languages;
+}
+
+PoIId TourModel::getPoIId(const std::string &poiName) const
+{
+    auto found = m_poiIds.find(poiName);
+    return found != m_poiIds.end() ? found->second : INVALID_ID;
+}
+
+const std::string &TourModel::getPoIName(PoIId poi) const
+{
+    return m_poiNames.at(poi);
+}
+
+CommandId TourModel::getCommandId(const std::string &command) const
+{
+    auto found = m_commandIds.find(command);
+    return found != m_commandIds.end() ? found->second : INVALID_ID;
+}
+
+const std::string &TourModel::getCommandName(CommandId command) const
+{
+    return m_commandNames.at(command);
+}
+
+const std::vector<std::string> &TourModel::getCommandNames() const
+{
+    return m_commandNames;
+}
+
+const PoIView *TourModel::getPoI(LanguageId lang, PoIId poi) const
+{
+    if (lang < 0 || static_cast<size_t>(lang) >= m_pois.size() || poi < 0 || static_cast<size_t>(poi) >= m_poiNames.size())
+    {
+        return nullptr;
+    }
+    const PoIView &view = m_pois[lang][poi];
+    return view.m_id != INVALID_ID ? &view : nullptr;
+}
+
+const PoIView *TourModel::getPoI(LanguageId lang, const std::string &poiName) const
+{
+    return getPoI(lang, getPoIId(poiName));
+}
+
+const PoIView *TourModel::getActivePoI(LanguageId lang, size_t index) const
+{
+    if (index >= m_activePoIs.size())
+    {
+        return nullptr;
+    }
+    return getPoI(lang, m_activePoIs[index]);
+}
+
+const PoIView *TourModel::getGenericPoI(LanguageId lang) const
+{
+    return getPoI(lang, m_genericPoI);
+}
+
+const LanguageSet *TourModel::getLanguageSet(LanguageId lang) const
+{
+    if (lang < 0 || static_cast<size_t>(lang) >= m_languageSets.size())
+    {
+        return nullptr;
+    }
+    return &m_languageSets[lang];
+}
+
+const std::vector<PoIId> &TourModel::getActivePoIs() const
+{
+    return m_activePoIs;
+}
+
+/**
+ *
+ * END OF TOUR_MODEL
+ *
+ */
@@ -0,0 +1,204 @@
+#include "tourSaxLoader.h"
+
+TourSaxLoader::TourSaxLoader(std::string tourName, const std::vector<std::string> &enabledLanguages) : m_tourName(std::move(tourName)),
+                                                                                                      m_enabledLanguages(enabledLanguages.begin(), enabledLanguages.end())
+{
+}
+
+bool TourSaxLoader::isSkipping() const
+{
+    return m_state != State::RECORDING || m_skipDepth >= 0;
+}
+
+bool TourSaxLoader::addValue(nlohmann::ordered_json &&value)
+{
+    if (m_skipNextValue)
+    {
+        m_skipNextValue = false;
+        return true;
+    }
+    if (isSkipping())
+    {
+        return true;
+    }
+
+    nlohmann::ordered_json &parent = *m_stack.back();
+    if (parent.is_object())
+    {
+        parent[m_key] = std::move(value);
+    }
+    else
+    {
+        parent.push_back(std::move(value));
+    }
+    return true;
+}
+
+bool TourSaxLoader::startContainer(nlohmann::ordered_json &&container)
+{
+    m_depth++;
+
+    if (m_state == State::SEEKING)
+    {
+        if (m_depth == 2 && m_isSelectedKey)
+        { // The value of the selected tour starts here
+            m_state = State::RECORDING;
+            m_tour = std::move(container);
+            m_stack.push_back(&m_tour);
+        }
+        return true;
+    }
+
+    if (m_skipNextValue)
+    {
+        m_skipNextValue = false;
+        m_skipDepth = m_depth;
+        return true;
+    }
+    if (isSkipping())
+    {
+        return true;
+    }
+
+    // The parent is only modified by its innermost open child, so this pointer stays valid until the child ends
+    nlohmann::ordered_json &parent = *m_stack.back();
+    if (parent.is_object())
+    {
+        parent[m_key] = std::move(container);
+        m_stack.push_back(&parent[m_key]);
+    }
+    else
+    {
+        parent.push_back(std::move(container));
+        m_stack.push_back(&parent.back());
+    }
+    return true;
+}
+
+bool TourSaxLoader::endContainer()
+{
+    if (m_skipDepth == m_depth)
+    {
+        m_skipDepth = -1;
+        m_depth--;
+        return true;
+    }
+    m_depth--;
+
+    if (isSkipping())
+    {
+        return true;
+    }
+
+    m_stack.pop_back();
+    if (m_stack.empty())
+    {
+        m_state = State::DONE;
+        return false; // Stop parsing, the rest of the file is not needed
+    }
+    return true;
+}
+
+bool TourSaxLoader::null()
+{
+    return addValue(nullptr);
+}
+
+bool TourSaxLoader::boolean(bool val)
+{
+    return addValue(val);
+}
+
+bool TourSaxLoader::number_integer(number_integer_t val)
+{
+    return addValue(val);
+}
+
+bool TourSaxLoader::number_unsigned(number_unsigned_t val)
+{
+    return addValue(val);
+}
+
+bool TourSaxLoader::number_float(number_float_t val, const string_t &s)
+{
+    return addValue(val);
+}
+
+bool TourSaxLoader::string(string_t &val)
+{
+    return addValue(std::move(val));
+}
+
+bool TourSaxLoader::binary(binary_t &val)
+{
+    return addValue(nlohmann::ordered_json::binary(val));
+}
+
+bool TourSaxLoader::start_object(std::size_t elements)
+{
+    return startContainer(nlohmann::ordered_json::object());
+}
+
+bool TourSaxLoader::key(string_t &val)
+{
+    if (m_state == State::SEEKING)
+    {
+        if (m_depth == 1)
+        {
+            m_isSelectedKey = val == m_tourName;
+        }
+        return true;
+    }
+    if (isSkipping())
+    {
+        return true;
+    }
+
+    if (m_depth == 2)
+    {
+        m_tourKey = val;
+    }
+    else if (m_depth == 3 && m_tourKey == "m_availablePoIs" && !m_enabledLanguages.empty() && m_enabledLanguages.count(val) == 0)
+    {
+        m_skipNextValue = true;
+        return true;
+    }
+    m_key = std::move(val);
+    return true;
+}
+
+bool TourSaxLoader::end_object()
+{
+    return endContainer();
+}
+
+bool TourSaxLoader::start_array(std::size_t elements)
+{
+    return startContainer(nlohmann::ordered_json::array());
+}
+
+bool TourSaxLoader::end_array()
+{
+    return endContainer();
+}
+
+bool TourSaxLoader::parse_error(std::size_t position, const std::string &last_token, const nlohmann::detail::exception &ex)
+{
+    m_error = ex.what();
+    return false;
+}
+
+bool TourSaxLoader::isComplete() const
+{
+    return m_state == State::DONE;
+}
+
+const std::string &TourSaxLoader::getError() const
+{
+    return m_error;
+}
+
+nlohmann::ordered_json &TourSaxLoader::getTour()
+{
+    return m_tour;
+}
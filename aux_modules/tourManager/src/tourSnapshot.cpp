@@ -0,0 +1,229 @@
+#include "tourSnapshot.h"
+#include "snapshotDecoder.h"
+#include <yarp/os/LogStream.h>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+YARP_LOG_COMPONENT(TOUR_SNAPSHOT, "behavior_tour_robot.aux_modules.TourManager.TourSnapshot", yarp::os::Log::TraceType)
+
+namespace
+{
+    constexpr char SNAPSHOT_MAGIC[4] = {'T', 'G', 'R', 'S'};
+    constexpr size_t HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + 2 * sizeof(std::uint32_t);
+
+    std::uint32_t ReadUInt32(const std::uint8_t *data)
+    {
+        return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+               (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    void WriteUInt32(std::ofstream &out, std::uint32_t value)
+    {
+        char bytes[4] = {static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+                         static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)};
+        out.write(bytes, sizeof(bytes));
+    }
+}
+
+TourSnapshot::~TourSnapshot()
+{
+    Close();
+}
+
+bool TourSnapshot::Open(const std::string &path)
+{
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        yCError(TOUR_SNAPSHOT) << "Cannot open snapshot" << path;
+        return false;
+    }
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < HEADER_SIZE)
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot" << path << "is too small";
+        ::close(fd);
+        return false;
+    }
+    void *mapped = ::mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (mapped == MAP_FAILED)
+    {
+        yCError(TOUR_SNAPSHOT) << "Cannot map snapshot" << path;
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t *>(mapped);
+    m_size = fileStat.st_size;
+
+    if (std::memcmp(m_data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || ReadUInt32(m_data + 4) != FORMAT_VERSION)
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot" << path << "is not a valid snapshot or has a different format version. Recompile it with tourCompiler.";
+        Close();
+        return false;
+    }
+    std::uint32_t indexSize = ReadUInt32(m_data + 8);
+    if (HEADER_SIZE + indexSize > m_size)
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot" << path << "is truncated";
+        Close();
+        return false;
+    }
+
+    try
+    {
+        m_index = nlohmann::json::from_msgpack(m_data + HEADER_SIZE, m_data + HEADER_SIZE + indexSize);
+        m_blobsOffset = HEADER_SIZE + indexSize;
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot" << path << "has a corrupted index:" << e.what();
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void TourSnapshot::Close()
+{
+    if (m_data)
+    {
+        ::munmap(const_cast<std::uint8_t *>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_blobsOffset = 0;
+    m_index = nullptr;
+}
+
+bool TourSnapshot::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+bool TourSnapshot::GetBlob(const nlohmann::json &entry, const std::uint8_t *&outBegin, size_t &outSize) const
+{
+    // The index comes from the file, so its entries are checked before being used as offsets
+    if (!entry.is_array() || entry.size() != 2 || !entry[0].is_number_unsigned() || !entry[1].is_number_unsigned())
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot index entry is corrupted";
+        return false;
+    }
+    std::uint64_t offset = entry[0].get<std::uint64_t>();
+    std::uint64_t size = entry[1].get<std::uint64_t>();
+    std::uint64_t blobsSize = m_size - m_blobsOffset;
+    if (offset > blobsSize || size > blobsSize - offset) // Never computes offset + size, which could overflow
+    {
+        yCError(TOUR_SNAPSHOT) << "Snapshot blob out of range. The snapshot is truncated.";
+        return false;
+    }
+    outBegin = m_data + m_blobsOffset + offset;
+    outSize = static_cast<size_t>(size);
+    return true;
+}
+
+bool TourSnapshot::ReadTour(const std::string &tourName, const std::vector<std::string> &languages, Tour &outTour) const
+{
+    if (!IsOpen() || !m_index.is_object() || !m_index.contains("tours") || !m_index["tours"].is_object() || !m_index["tours"].contains(tourName))
+    {
+        return false;
+    }
+    const std::uint8_t *blob = nullptr;
+    size_t size = 0;
+    if (!GetBlob(m_index["tours"][tourName], blob, size))
+    {
+        return false;
+    }
+
+    TourDecoder decoder(languages);
+    try
+    {
+        nlohmann::json::sax_parse(blob, blob + size, &decoder, nlohmann::json::input_format_t::msgpack);
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_SNAPSHOT) << "Tour" << tourName << "of the snapshot is corrupted:" << e.what();
+        return false;
+    }
+    if (!decoder.isComplete())
+    {
+        yCError(TOUR_SNAPSHOT) << "Tour" << tourName << "of the snapshot is corrupted:" << (decoder.getError().empty() ? "missing fields" : decoder.getError());
+        return false;
+    }
+    outTour = decoder.getTour();
+    return true;
+}
+
+bool TourSnapshot::ReadMovements(MovementsContainer &outMovements, std::map<std::string, float> &outDurations) const
+{
+    if (!IsOpen() || !m_index.is_object() || !m_index.contains("movements"))
+    {
+        return false;
+    }
+    const std::uint8_t *blob = nullptr;
+    size_t size = 0;
+    if (!GetBlob(m_index["movements"], blob, size))
+    {
+        return false;
+    }
+
+    MovementsDecoder decoder;
+    try
+    {
+        nlohmann::json::sax_parse(blob, blob + size, &decoder, nlohmann::json::input_format_t::msgpack);
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_SNAPSHOT) << "Movements of the snapshot are corrupted:" << e.what();
+        return false;
+    }
+    if (!decoder.isComplete())
+    {
+        yCError(TOUR_SNAPSHOT) << "Movements of the snapshot are corrupted:" << (decoder.getError().empty() ? "missing fields" : decoder.getError());
+        return false;
+    }
+    outMovements = decoder.getMovements();
+    outDurations = std::move(decoder.getDurations()); // Missing for the dances added after the compilation, they are computed on load
+    return true;
+}
+
+bool TourSnapshot::Write(const std::string &path, const nlohmann::ordered_json &tours, const nlohmann::ordered_json &movements, const std::map<std::string, float> &durations)
+{
+    std::vector<std::uint8_t> blobs;
+    nlohmann::json index;
+
+    for (const auto &tour : tours.items())
+    {
+        std::vector<std::uint8_t> blob = nlohmann::ordered_json::to_msgpack(tour.value());
+        index["tours"][tour.key()] = {blobs.size(), blob.size()};
+        blobs.insert(blobs.end(), blob.begin(), blob.end());
+    }
+
+    nlohmann::ordered_json movementsBlob;
+    movementsBlob["movements"] = movements;
+    movementsBlob["durations"] = durations;
+    std::vector<std::uint8_t> blob = nlohmann::ordered_json::to_msgpack(movementsBlob);
+    index["movements"] = {blobs.size(), blob.size()};
+    blobs.insert(blobs.end(), blob.begin(), blob.end());
+
+    std::vector<std::uint8_t> encodedIndex = nlohmann::json::to_msgpack(index);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        yCError(TOUR_SNAPSHOT) << "Cannot write snapshot" << path;
+        return false;
+    }
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    WriteUInt32(out, FORMAT_VERSION);
+    WriteUInt32(out, static_cast<std::uint32_t>(encodedIndex.size()));
+    out.write(reinterpret_cast<const char *>(encodedIndex.data()), encodedIndex.size());
+    out.write(reinterpret_cast<const char *>(blobs.data()), blobs.size());
+    return out.good();
+}
@@ -2,10 +2,23 @@
 
 YARP_LOG_COMPONENT(TOUR_STORAGE, "behavior_tour_robot.aux_modules.tourstorage", yarp::os::Log::TraceType)
 
-TourStorage &TourStorage::GetInstance(const std::string &pathJSONTours, const std::string &tourName)
+TourStorage &TourStorage::GetInstance()
 {
     static TourStorage instance; // Guaranteed to be destroyed. Instantiated on first use.
-    instance.LoadTour(pathJSONTours, tourName);
+    return instance;
+}
+
+TourStorage &TourStorage::GetInstance(const std::string &pathJSONTours, const std::string &tourName, const std::vector<std::string> &languages)
+{
+    TourStorage &instance = GetInstance();
+    instance.LoadTour(pathJSONTours, tourName, languages);
+    return instance;
+}
+
+TourStorage &TourStorage::GetInstance(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages)
+{
+    TourStorage &instance = GetInstance();
+    instance.LoadTour(snapshot, tourName, languages);
     return instance;
 }
 
@@ -33,27 +46,107 @@ bool TourStorage::WriteJSONtoFile(const nlohmann::ordered_json &j, const std::st
     }
 }
 
-bool TourStorage::LoadTour(const std::string &pathTours, const std::string &tourName)
+bool TourStorage::LoadTour(const std::string &pathTours, const std::string &tourName, const std::vector<std::string> &languages)
 {
-
-    // Load tour
-    nlohmann::ordered_json tours_json = ReadFileAsJSON(pathTours);
-    std::unordered_map<std::string, Tour> tours = tours_json.get<std::unordered_map<std::string, Tour>>();
-    auto foundTour = tours.find(tourName);
-    if (foundTour != tours.end())
+    // The dance durations of the action plans are precomputed from the movements, which are always loaded first
+    MovementStorage::ContainerGuard movements = MovementStorage::GetInstance().GetMovementsContainer();
+    std::unique_ptr<const TourModel> model = BuildTour(pathTours, tourName, languages, movements.get());
+    if (!model)
     {
-        m_loadedTour = foundTour->second;
-        yCInfo(TOUR_STORAGE) << "Loaded tour:" << foundTour->first;
+        return false;
     }
-    else
+    Publish(std::move(model), tourName);
+    return true;
+}
+
+bool TourStorage::LoadTour(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages)
+{
+    MovementStorage::ContainerGuard movements = MovementStorage::GetInstance().GetMovementsContainer();
+    std::unique_ptr<const TourModel> model = BuildTour(snapshot, tourName, languages, movements.get());
+    if (!model)
     {
-        yCError(TOUR_STORAGE) << "Tour" << tourName << "not found";
         return false;
     }
+    Publish(std::move(model), tourName);
     return true;
 }
 
-Tour &TourStorage::GetTour()
+std::unique_ptr<const TourModel> TourStorage::BuildTour(const std::string &pathTours, const std::string &tourName, const std::vector<std::string> &languages, const MovementsContainer *movements)
+{
+    std::ifstream file(pathTours);
+    if (!file.is_open())
+    {
+        yCError(TOUR_STORAGE) << "Cannot open tours file" << pathTours;
+        return nullptr;
+    }
+
+    // Load only the selected tour. The other tours are skipped by the SAX loader without building them
+    TourSaxLoader loader(tourName, languages);
+    nlohmann::ordered_json::sax_parse(file, &loader);
+    if (!loader.isComplete())
+    {
+        if (!loader.getError().empty())
+        {
+            yCError(TOUR_STORAGE) << "Failed to parse" << pathTours << ":" << loader.getError();
+        }
+        else
+        {
+            yCError(TOUR_STORAGE) << "Tour" << tourName << "not found";
+        }
+        return nullptr;
+    }
+
+    return BuildModel(loader.getTour(), tourName, movements);
+}
+
+std::unique_ptr<const TourModel> TourStorage::BuildTour(const TourSnapshot &snapshot, const std::string &tourName, const std::vector<std::string> &languages, const MovementsContainer *movements)
+{
+    // The disabled languages are skipped by the decoder, which builds the Tour without a json DOM
+    Tour tour;
+    if (!snapshot.ReadTour(tourName, languages, tour))
+    {
+        yCError(TOUR_STORAGE) << "Tour" << tourName << "not found in the snapshot";
+        return nullptr;
+    }
+    return BuildModel(tour, tourName, movements);
+}
+
+std::unique_ptr<const TourModel> TourStorage::BuildModel(const nlohmann::ordered_json &tourJson, const std::string &tourName, const MovementsContainer *movements)
+{
+    Tour tour;
+    try
+    {
+        tour = tourJson.get<Tour>();
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_STORAGE) << "Tour" << tourName << "is not valid:" << e.what(); // The previously loaded tour, if any, is kept
+        return nullptr;
+    }
+    return BuildModel(tour, tourName, movements);
+}
+
+std::unique_ptr<const TourModel> TourStorage::BuildModel(const Tour &tour, const std::string &tourName, const MovementsContainer *movements)
+{
+    try
+    {
+        return std::make_unique<const TourModel>(tour, movements); // The dance durations of the action plans are precomputed from the movements
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_STORAGE) << "Tour" << tourName << "is not valid:" << e.what(); // The previously loaded tour, if any, is kept
+        return nullptr;
+    }
+}
+
+void TourStorage::Publish(std::unique_ptr<const TourModel> model, const std::string &tourName)
+{
+    size_t languagesNum = model->getAvailableLanguages().size();
+    m_tourModel.publish(std::move(model)); // Readers that pinned the previous model keep using it until they release it
+    yCInfo(TOUR_STORAGE) << "Loaded tour:" << tourName << "with" << languagesNum << "languages";
+}
+
+TourStorage::ModelGuard TourStorage::GetTourModel() const
 {
-    return m_loadedTour;
+    return m_tourModel.read();
 }
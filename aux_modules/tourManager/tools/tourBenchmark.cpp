@@ -0,0 +1,757 @@
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Time.h>
+#include <tourManager.h>
+#include <tourClock.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+YARP_LOG_COMPONENT(TOUR_BENCHMARK, "behavior_tour_robot.aux_modules.TourManager.TourBenchmark", yarp::os::Log::TraceType)
+
+/**
+ * Headless benchmark of the TourManager.
+ *
+ * Drives a TourManager through a scenario against in-process stand-ins of the headSynchronizer, the google
+ * services, the ctpService and the navigation, so that neither the robot nor the cloud are needed, and reports
+ * the latency percentiles, the allocations and the time spent in waits of every command.
+ *
+ * The scenario is a text file with one step per line ('#' starts a comment):
+ *     dialog <command>   executes a command as if it was received from googleDialog and waits for it
+ *     say <text>         passes a transcription through the local intents and waits for the resulting command.
+ *                        Reported as "say local" when matched locally, "say cloud" when answered by googleDialog
+ *     error <error>      calls sendError, e.g. error TOUCHED_ERROR
+ *     sendToPoI          starts the navigation to the current PoI in background
+ *     waitNavigation     waits for the navigation started by sendToPoI to end
+ *     nav <status>       sets the navigation status: idle, moving, goal_reached, aborted, paused or failing
+ *     sleep <seconds>    waits
+ *
+ * tourBenchmark --nameJSONTours tours.json --nameJSONMovements movements.json --tourName TOUR_MADAMA --scenario madama.scenario
+ *
+ * With --clock simulated the dances, the delays and the navigations of the stand-ins run --clockScale times faster,
+ * and all the reported times are in simulated seconds.
+ *
+ * With --localIntents intents.json the transcriptions of the say steps are matched locally first. The stand-in of
+ * googleDialog answers the others after --dialogLatency seconds, with the command of the phrase they are equal to
+ * or with fallback.
+ */
+
+static std::atomic<std::uint64_t> g_allocations{0}; // Only counted while a step is measured
+static std::atomic<int> g_measures{0};               // Steps being measured, the navigation spans several steps
+
+void *operator new(std::size_t size)
+{
+    if (g_measures.load(std::memory_order_relaxed) > 0)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Stand-in of the headSynchronizer. A text is spoken for secondsPerChar seconds per character
+ */
+class HeadSynchronizerStandIn : public headSynchronizerRPC
+{
+private:
+    std::mutex m_mutex;
+    double m_secondsPerChar;
+    double m_speakingUntil{0.0};
+    bool m_isSpeaking{false};
+    std::int64_t m_lastUtterance{0};
+    std::int64_t m_doneUtterance{0};
+    yarp::os::Port m_rpcPort;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_statusPort;
+    yarp::os::BufferedPort<yarp::os::Bottle> m_eventsPort;
+    std::atomic<bool> m_isStopping{false};
+    std::thread m_thread;
+
+    void Publish(const std::string &status)
+    {
+        yarp::os::Bottle &b = m_statusPort.prepare();
+        b.clear();
+        b.addString(status);
+        m_statusPort.write();
+    }
+
+    void PublishEvent(const std::string &event, std::int64_t id)
+    {
+        yarp::os::Bottle &b = m_eventsPort.prepare();
+        b.clear();
+        b.addString(event);
+        b.addInt64(id);
+        b.addFloat64(yarp::os::Time::now());
+        m_eventsPort.writeStrict();
+    }
+
+    void Run()
+    {
+        while (!m_isStopping)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_isSpeaking && yarp::os::Time::now() >= m_speakingUntil)
+                {
+                    m_isSpeaking = false;
+                    m_doneUtterance = m_lastUtterance; // The texts are spoken one after the other, so all of them are finished
+                    PublishEvent("finished", m_doneUtterance);
+                    Publish("idle");
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+public:
+    explicit HeadSynchronizerStandIn(double secondsPerChar) : m_secondsPerChar(secondsPerChar)
+    {
+    }
+
+    bool Open()
+    {
+        if (!m_rpcPort.open("/HeadSynchronizer/thrift:s") || !m_statusPort.open("/HeadSynchronizer/speechStatus:o") || !m_eventsPort.open("/HeadSynchronizer/speechEvents:o"))
+        {
+            return false;
+        }
+        yarp().attachAsServer(m_rpcPort);
+        m_thread = std::thread([this]
+                               { Run(); });
+        return true;
+    }
+
+    void Close()
+    {
+        m_isStopping = true;
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+        m_rpcPort.close();
+        m_statusPort.close();
+        m_eventsPort.close();
+    }
+
+    bool say(const std::string &text) override
+    {
+        return sayUtterance(text) > 0;
+    }
+
+    std::int64_t sayUtterance(const std::string &text) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_speakingUntil = std::max(m_speakingUntil, yarp::os::Time::now()) + text.size() * m_secondsPerChar;
+        m_lastUtterance++;
+        PublishEvent("queued", m_lastUtterance);
+        if (!m_isSpeaking)
+        {
+            m_isSpeaking = true;
+            Publish("speaking");
+        }
+        return m_lastUtterance;
+    }
+
+    bool waitForUtterance(const std::int64_t id, const double timeout) override
+    {
+        double endTime = yarp::os::Time::now() + timeout;
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (id <= m_doneUtterance)
+                {
+                    return true;
+                }
+            }
+            if (timeout >= 0.0 && yarp::os::Time::now() >= endTime)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    bool isSpeaking() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_isSpeaking;
+    }
+
+    bool reset() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_speakingUntil = 0.0;
+        m_doneUtterance = m_lastUtterance;
+        PublishEvent("reset", m_doneUtterance);
+        return true;
+    }
+
+    bool pauseSpeaking() override { return true; }
+    bool continueSpeaking() override { return true; }
+    bool isHearing() override { return false; }
+    bool startHearing() override { return true; }
+    bool stopHearing() override { return true; }
+    bool sadFaceWarning() override { return true; }
+    bool sadFaceError() override { return true; }
+    bool busyFaceError() override { return true; }
+    bool happyFace() override { return true; }
+    bool busyFace() override { return true; }
+    bool prepareSpeech(const std::vector<std::string> &) override { return false; } // Nothing is synthesized
+};
+
+/**
+ * Stand-ins of the google services. They only keep the selected language
+ */
+class GoogleSpeechStandIn : public googleSpeech_IDL
+{
+private:
+    std::string m_language;
+
+public:
+    bool setLanguage(const std::string &languageCode) override
+    {
+        m_language = languageCode;
+        return true;
+    }
+    std::string getLanguageCode() override { return m_language; }
+};
+
+class GoogleDialogStandIn : public googleDialog_IDL
+{
+private:
+    std::string m_language;
+
+public:
+    bool setLanguage(const std::string &languageCode) override
+    {
+        m_language = languageCode;
+        return true;
+    }
+    std::string getLanguageCode() override { return m_language; }
+};
+
+/**
+ * Stand-in of the text input of googleDialog. The utterances expected by the scenario are answered after latency
+ * seconds with the command of the example phrase they are equal to, or with fallback. The other texts, e.g. startpoi,
+ * are ignored
+ */
+class GoogleDialogTextStandIn : public yarp::os::PortReader
+{
+private:
+    TourManager &m_manager;
+    double m_latency;
+    std::map<std::string, std::string> m_commands; // Normalized phrase to command
+    std::mutex m_mutex;
+    std::condition_variable m_resultCondition;
+    std::string m_expected;
+    std::shared_future<bool> m_result;
+
+public:
+    GoogleDialogTextStandIn(TourManager &manager, double latency) : m_manager(manager),
+                                                                    m_latency(latency)
+    {
+    }
+
+    bool Load(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+        nlohmann::json intents = nlohmann::json::parse(file, nullptr, false);
+        if (intents.is_discarded())
+        {
+            return false;
+        }
+        for (const auto &language : intents.items())
+        {
+            for (const auto &command : language.value().items())
+            {
+                for (const auto &phrase : command.value())
+                {
+                    m_commands[IntentIndex::Normalize(phrase.get<std::string>())] = command.key();
+                }
+            }
+        }
+        return true;
+    }
+
+    void Expect(const std::string &text)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_expected = text;
+        m_result = std::shared_future<bool>();
+    }
+
+    std::shared_future<bool> WaitResult()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_resultCondition.wait(lock, [this]
+                               { return m_result.valid(); });
+        return m_result;
+    }
+
+    bool read(yarp::os::ConnectionReader &connection) override
+    {
+        yarp::os::Bottle text;
+        if (!text.read(connection))
+        {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (text.get(0).asString() != m_expected)
+            {
+                return true;
+            }
+        }
+        yarp::os::Time::delay(m_latency);
+        auto command = m_commands.find(IntentIndex::Normalize(text.get(0).asString()));
+        std::shared_future<bool> result = m_manager.OnDialogResult(command != m_commands.end() ? command->second : "fallback");
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_expected.clear();
+            m_result = result;
+        }
+        m_resultCondition.notify_all();
+        return true;
+    }
+};
+
+class GoogleSynthesisStandIn : public googleSynthesis_IDL
+{
+private:
+    std::string m_language;
+
+public:
+    std::string setLanguage(const std::string &languageCode, const std::string &voiceCode) override
+    {
+        m_language = languageCode;
+        return voiceCode;
+    }
+    std::string getLanguageCode() override { return m_language; }
+};
+
+/**
+ * Stand-in of the ctpService of a robot part. Every movement is accepted immediately
+ */
+class CtpServiceStandIn : public yarp::os::PortReader
+{
+public:
+    std::atomic<int> m_movementsNum{0};
+
+    bool read(yarp::os::ConnectionReader &connection) override
+    {
+        yarp::os::Bottle command;
+        if (!command.read(connection))
+        {
+            return false;
+        }
+        m_movementsNum++;
+        yarp::os::Bottle reply;
+        reply.addVocab32("ack");
+        if (yarp::os::ConnectionWriter *writer = connection.getWriter())
+        {
+            reply.write(*writer);
+        }
+        return true;
+    }
+};
+
+/**
+ * Stand-in of the navigation. Every location exists, every goal is reached after navigationTime seconds
+ * unless the status is set by the scenario
+ */
+class NavigationStandIn : public NavigationInterface
+{
+private:
+    std::mutex m_mutex;
+    double m_navigationTime;
+    double m_goalTime{-1.0}; // Time at which the current goal is reached, negative if it is not automatic
+    bool m_isHeld{false};    // Suspended before the goal was sent, the goal waits for the resume
+    std::map<std::string, int> m_locations;
+    yarp::dev::Nav2D::NavigationStatusEnum m_status{yarp::dev::Nav2D::navigation_status_idle};
+
+public:
+    explicit NavigationStandIn(double navigationTime) : m_navigationTime(navigationTime)
+    {
+    }
+
+    void SetStatus(yarp::dev::Nav2D::NavigationStatusEnum status)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_status = status;
+        m_goalTime = -1.0;
+        m_isHeld = false;
+    }
+
+    bool getLocation(const std::string &locationName, yarp::dev::Nav2D::Map2DLocation &location) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_locations.emplace(locationName, static_cast<int>(m_locations.size())).first;
+        location.map_id = "benchmark";
+        location.x = found->second + 1.0; // Every PoI in a different place
+        return true;
+    }
+
+    bool gotoTargetByLocationName(const std::string &) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_status = m_isHeld ? yarp::dev::Nav2D::navigation_status_paused : yarp::dev::Nav2D::navigation_status_moving;
+        m_goalTime = yarp::os::Time::now() + m_navigationTime;
+        return true;
+    }
+
+    bool getNavigationStatus(yarp::dev::Nav2D::NavigationStatusEnum &status) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_goalTime >= 0.0 && m_status == yarp::dev::Nav2D::navigation_status_moving && yarp::os::Time::now() >= m_goalTime)
+        {
+            m_status = yarp::dev::Nav2D::navigation_status_goal_reached;
+            m_goalTime = -1.0;
+        }
+        status = m_status;
+        return true;
+    }
+
+    bool stopNavigation() override
+    {
+        SetStatus(yarp::dev::Nav2D::navigation_status_idle);
+        return true;
+    }
+
+    bool suspendNavigation(double) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isHeld = true;
+        m_status = yarp::dev::Nav2D::navigation_status_paused;
+        return true;
+    }
+
+    bool resumeNavigation() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isHeld = false;
+        m_status = yarp::dev::Nav2D::navigation_status_moving;
+        m_goalTime = yarp::os::Time::now() + m_navigationTime;
+        return true;
+    }
+};
+
+/**
+ * Measures of all the executions of a step
+ */
+struct StepStatistics
+{
+    std::vector<double> latencies;
+    std::uint64_t allocations{0};
+    double waitTime{0.0};
+};
+
+class Measure
+{
+private:
+    double m_startTime;
+    std::uint64_t m_startAllocations;
+    double m_startWaitTime;
+    TourManager &m_manager;
+
+public:
+    explicit Measure(TourManager &manager) : m_startTime(yarp::os::Time::now()),
+                                             m_startAllocations(g_allocations),
+                                             m_startWaitTime(manager.GetWaitTime()),
+                                             m_manager(manager)
+    {
+        g_measures++;
+    }
+
+    ~Measure()
+    {
+        g_measures--;
+    }
+
+    Measure(const Measure &) = delete;
+    Measure &operator=(const Measure &) = delete;
+
+    void AddTo(StepStatistics &statistics) const
+    {
+        statistics.latencies.push_back(yarp::os::Time::now() - m_startTime);
+        statistics.allocations += g_allocations - m_startAllocations;
+        statistics.waitTime += m_manager.GetWaitTime() - m_startWaitTime;
+    }
+};
+
+bool ParseStatus(const std::string &name, yarp::dev::Nav2D::NavigationStatusEnum &status)
+{
+    static const std::map<std::string, yarp::dev::Nav2D::NavigationStatusEnum> statuses = {
+        {"idle", yarp::dev::Nav2D::navigation_status_idle},
+        {"moving", yarp::dev::Nav2D::navigation_status_moving},
+        {"goal_reached", yarp::dev::Nav2D::navigation_status_goal_reached},
+        {"aborted", yarp::dev::Nav2D::navigation_status_aborted},
+        {"paused", yarp::dev::Nav2D::navigation_status_paused},
+        {"failing", yarp::dev::Nav2D::navigation_status_failing}};
+    auto found = statuses.find(name);
+    if (found == statuses.end())
+    {
+        return false;
+    }
+    status = found->second;
+    return true;
+}
+
+double Percentile(std::vector<double> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+bool RunScenario(const std::vector<std::string> &steps, TourManager &manager, NavigationStandIn &navigation, GoogleDialogTextStandIn &dialogText, std::map<std::string, StepStatistics> &statistics)
+{
+    std::int32_t navigationJob = -1;
+    std::unique_ptr<Measure> navigationMeasure;
+
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        std::istringstream line(steps[i]);
+        std::string step, param;
+        line >> step >> param;
+
+        if (step == "dialog")
+        {
+            Measure measure(manager);
+            manager.PostCommand(param, CommandPriority::DIALOG).get();
+            measure.AddTo(statistics["dialog " + param]);
+        }
+        else if (step == "say")
+        {
+            std::string text = steps[i].substr(steps[i].find("say") + 3);
+            text = text.substr(std::min(text.find_first_not_of(" \t"), text.size()));
+            dialogText.Expect(text);
+            Measure measure(manager);
+            std::shared_future<bool> result = manager.OnTranscription(text);
+            bool isLocal = result.valid();
+            if (!isLocal)
+            {
+                result = dialogText.WaitResult();
+            }
+            result.get();
+            measure.AddTo(statistics[isLocal ? "say local" : "say cloud"]);
+        }
+        else if (step == "error")
+        {
+            Measure measure(manager);
+            manager.sendError(param);
+            measure.AddTo(statistics["error " + param]);
+        }
+        else if (step == "sendToPoI")
+        {
+            navigationMeasure = std::make_unique<Measure>(manager);
+            navigationJob = manager.sendToPoIAsync();
+        }
+        else if (step == "waitNavigation")
+        {
+            std::string status = manager.getJobStatus(navigationJob);
+            while (status == "pending" || status == "running")
+            {
+                yarp::os::Time::delay(0.001);
+                status = manager.getJobStatus(navigationJob);
+            }
+            if (navigationMeasure)
+            {
+                navigationMeasure->AddTo(statistics["sendToPoI " + status]);
+                navigationMeasure.reset();
+            }
+        }
+        else if (step == "nav")
+        {
+            yarp::dev::Nav2D::NavigationStatusEnum status;
+            if (!ParseStatus(param, status))
+            {
+                yCError(TOUR_BENCHMARK) << "Unknown navigation status" << param << "at step" << i + 1;
+                return false;
+            }
+            navigation.SetStatus(status);
+        }
+        else if (step == "sleep")
+        {
+            double duration = 0.0;
+            try
+            {
+                duration = std::stod(param);
+            }
+            catch (const std::exception &)
+            {
+                yCError(TOUR_BENCHMARK) << "Invalid sleep duration" << param << "at step" << i + 1;
+                return false;
+            }
+            yarp::os::Time::delay(duration);
+        }
+        else
+        {
+            yCError(TOUR_BENCHMARK) << "Unknown step" << steps[i] << "at step" << i + 1;
+            return false;
+        }
+    }
+    return true;
+}
+
+void Report(const std::map<std::string, StepStatistics> &statistics)
+{
+    std::cout << std::left << std::setw(40) << "step" << std::right
+              << std::setw(7) << "count" << std::setw(11) << "p50 [ms]" << std::setw(11) << "p90 [ms]"
+              << std::setw(11) << "p99 [ms]" << std::setw(11) << "max [ms]" << std::setw(13) << "allocs/run"
+              << std::setw(12) << "wait/run [s]" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto &step : statistics)
+    {
+        const StepStatistics &s = step.second;
+        size_t count = s.latencies.size();
+        std::cout << std::left << std::setw(40) << step.first << std::right
+                  << std::setw(7) << count
+                  << std::setw(11) << Percentile(s.latencies, 0.50) * 1000.0
+                  << std::setw(11) << Percentile(s.latencies, 0.90) * 1000.0
+                  << std::setw(11) << Percentile(s.latencies, 0.99) * 1000.0
+                  << std::setw(11) << *std::max_element(s.latencies.begin(), s.latencies.end()) * 1000.0
+                  << std::setw(13) << s.allocations / count
+                  << std::setw(12) << s.waitTime / count << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    yarp::os::Network yarp;
+    yarp::os::Network::setLocalMode(true); // All the ports live in this process, no name server is needed
+
+    yarp::os::ResourceFinder rf;
+    rf.configure(argc, argv);
+    if (!rf.check("scenario") || !ConfigureClock(rf))
+    {
+        yCError(TOUR_BENCHMARK) << "Usage: tourBenchmark --scenario <file> [--nameJSONTours tours.json] [--nameJSONMovements movements.json] [--tourName TOUR_SIM_GAM] [--repeat 1] [--navigationTime 0.5] [--secondsPerChar 0.0] [--clock simulated --clockScale 100 --clockEpoch <system time>] [--localIntents intents.json] [--dialogLatency 0.5]";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> steps;
+    std::ifstream scenario(rf.findFileByName(rf.find("scenario").asString()));
+    for (std::string line; std::getline(scenario, line);)
+    {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            steps.push_back(line);
+        }
+    }
+    if (steps.empty())
+    {
+        yCError(TOUR_BENCHMARK) << "The scenario is empty or cannot be read";
+        return EXIT_FAILURE;
+    }
+
+    std::string nameJSONTours = rf.check("nameJSONTours") ? rf.find("nameJSONTours").asString() : "tours.json";
+    std::string nameJSONMovements = rf.check("nameJSONMovements") ? rf.find("nameJSONMovements").asString() : "movements.json";
+    std::string tourName = rf.check("tourName") ? rf.find("tourName").asString() : "TOUR_SIM_GAM";
+    int repeat = rf.check("repeat") ? rf.find("repeat").asInt32() : 1;
+
+    HeadSynchronizerStandIn headSynchronizer(rf.check("secondsPerChar") ? rf.find("secondsPerChar").asFloat64() : 0.0);
+    GoogleSpeechStandIn speech;
+    GoogleDialogStandIn dialog;
+    GoogleSynthesisStandIn synthesis;
+    yarp::os::Port speechPort, dialogPort, synthesisPort;
+    if (!headSynchronizer.Open() || !speechPort.open("/googleSpeech/rpc") || !dialogPort.open("/googleDialog/rpc") || !synthesisPort.open("/googleSynthesis/rpc"))
+    {
+        yCError(TOUR_BENCHMARK) << "Cannot open the ports of the stand-ins";
+        return EXIT_FAILURE;
+    }
+    speech.yarp().attachAsServer(speechPort);
+    dialog.yarp().attachAsServer(dialogPort);
+    synthesis.yarp().attachAsServer(synthesisPort);
+    NavigationStandIn navigation(rf.check("navigationTime") ? rf.find("navigationTime").asFloat64() : 0.5);
+
+    TourManager manager("TourBenchmark", rf.findFileByName(nameJSONTours), rf.findFileByName(nameJSONMovements), tourName);
+
+    GoogleDialogTextStandIn dialogText(manager, rf.check("dialogLatency") ? rf.find("dialogLatency").asFloat64() : 0.5);
+    yarp::os::Port dialogTextPort;
+    dialogTextPort.setReader(dialogText);
+    if (!dialogTextPort.open("/googleDialog/text:i"))
+    {
+        yCError(TOUR_BENCHMARK) << "Cannot open the ports of the stand-ins";
+        return EXIT_FAILURE;
+    }
+    if (rf.check("localIntents") && !dialogText.Load(rf.findFileByName(rf.find("localIntents").asString())))
+    {
+        yCWarning(TOUR_BENCHMARK) << "Cannot read the intents file. The stand-in of googleDialog answers every utterance with fallback.";
+    }
+
+    std::map<std::string, std::unique_ptr<yarp::os::Port>> ctpPorts;
+    std::map<std::string, std::unique_ptr<CtpServiceStandIn>> ctpServices;
+    if (MovementStorage::ContainerGuard movements = MovementStorage::GetInstance().GetMovementsContainer())
+    {
+        for (const std::string &part : movements->GetPartNames())
+        {
+            ctpServices[part] = std::make_unique<CtpServiceStandIn>();
+            ctpPorts[part] = std::make_unique<yarp::os::Port>();
+            ctpPorts[part]->setReader(*ctpServices[part]);
+            ctpPorts[part]->open("/ctpservice/" + part + "/rpc");
+        }
+    }
+
+    manager.SetNavigation(&navigation);
+    if (!manager.configure(rf))
+    {
+        yCError(TOUR_BENCHMARK) << "The TourManager failed to configure";
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, StepStatistics> statistics;
+    bool isCompleted = true;
+    double startTime = yarp::os::Time::now();
+    for (int i = 0; i < repeat && isCompleted; i++)
+    {
+        isCompleted = RunScenario(steps, manager, navigation, dialogText, statistics);
+    }
+    double duration = yarp::os::Time::now() - startTime;
+
+    manager.close();
+    for (auto &port : ctpPorts)
+    {
+        port.second->close();
+    }
+    speechPort.close();
+    dialogPort.close();
+    dialogTextPort.close();
+    synthesisPort.close();
+    headSynchronizer.Close();
+
+    int movementsNum = 0;
+    for (const auto &service : ctpServices)
+    {
+        movementsNum += service.second->m_movementsNum;
+    }
+    Report(statistics);
+    std::cout << "Scenario run " << repeat << " times in " << duration << " s, " << movementsNum << " movements sent." << std::endl;
+    return isCompleted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+#include <yarp/os/LogStream.h>
+#include <yarp/os/ResourceFinder.h>
+#include <tourSnapshot.h>
+#include <actionPlan.h>
+#include <tour.h>
+#include <movementStorage.h>
+#include <fstream>
+
+YARP_LOG_COMPONENT(TOUR_COMPILER, "behavior_tour_robot.aux_modules.TourManager.TourCompiler", yarp::os::Log::TraceType)
+
+/**
+ * Offline compiler of the tours and movements json files into a TourSnapshot.
+ * The content is validated before writing the snapshot, so that broken content is caught before it reaches the robot.
+ */
+
+static const char *GENERIC_POI = "___generic___";
+
+nlohmann::ordered_json ReadFileAsJSON(const std::string &path)
+{
+    std::ifstream file(path);
+    return nlohmann::ordered_json::parse(file);
+}
+
+int ValidateActions(const std::string &where, const std::vector<Action> &actions, MovementsContainer &movements)
+{
+    int errors = 0;
+    for (size_t i = 0; i < actions.size(); i++)
+    {
+        const Action &action = actions[i];
+        std::string location = where + "[" + std::to_string(i) + "]";
+        switch (action.getType())
+        {
+        case ActionTypes::SPEAK:
+            if (action.getParam().empty())
+            {
+                yCError(TOUR_COMPILER) << location << ": speak action with empty text";
+                errors++;
+            }
+            break;
+        case ActionTypes::DANCE:
+            if (movements.GetDances().count(action.getParam()) == 0)
+            {
+                yCError(TOUR_COMPILER) << location << ": dance" << action.getParam() << "does not exist in the movements";
+                errors++;
+            }
+            break;
+        case ActionTypes::SIGNAL:
+            if (SignalCommand::Parse(action.getParam()).type == SignalTypes::INVALID) // Same parsing as the action plans of the module
+            {
+                yCError(TOUR_COMPILER) << location << ": signal" << action.getParam() << "is not valid";
+                errors++;
+            }
+            break;
+        default:
+            yCError(TOUR_COMPILER) << location << ": invalid action type";
+            errors++;
+            break;
+        }
+    }
+    return errors;
+}
+
+int ValidateTour(const std::string &tourName, const Tour &tour, MovementsContainer &movements)
+{
+    int errors = 0;
+    for (const auto &language : tour.getAvailablePoIs())
+    {
+        std::string where = tourName + "/" + language.first;
+        if (language.second.count(GENERIC_POI) == 0)
+        {
+            yCError(TOUR_COMPILER) << where << ": the generic PoI" << GENERIC_POI << "is missing";
+            errors++;
+        }
+        for (const std::string &activePoI : tour.getPoIsList())
+        {
+            if (language.second.count(activePoI) == 0)
+            {
+                yCError(TOUR_COMPILER) << where << ": the active PoI" << activePoI << "is missing";
+                errors++;
+            }
+        }
+        for (const auto &poi : language.second)
+        {
+            for (const auto &command : poi.second.getAvailableActions())
+            {
+                errors += ValidateActions(where + "/" + poi.first + "/" + command.first, command.second, movements);
+            }
+        }
+    }
+    return errors;
+}
+
+int ValidateMovements(MovementsContainer &movements)
+{
+    int errors = 0;
+    for (const auto &dance : movements.GetDances())
+    {
+        for (const Movement &movement : dance.second.GetMovements())
+        {
+            if (movements.GetPartNames().count(movement.GetPartName()) == 0)
+            {
+                yCError(TOUR_COMPILER) << "dance" << dance.first << ": part" << movement.GetPartName() << "is not in the part names";
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    yarp::os::ResourceFinder rf;
+    rf.configure(argc, argv);
+    if (!rf.check("tours") || !rf.check("movements") || !rf.check("output"))
+    {
+        yCError(TOUR_COMPILER) << "Usage: tourCompiler --tours <tours.json> --movements <movements.json> --output <snapshot file>";
+        return EXIT_FAILURE;
+    }
+    std::string pathTours = rf.find("tours").asString();
+    std::string pathMovements = rf.find("movements").asString();
+    std::string pathOutput = rf.find("output").asString();
+
+    nlohmann::ordered_json toursJson;
+    nlohmann::ordered_json movementsJson;
+    MovementsContainer movements;
+    std::map<std::string, Tour> tours;
+    try
+    {
+        toursJson = ReadFileAsJSON(pathTours);
+        movementsJson = ReadFileAsJSON(pathMovements);
+        movements = movementsJson.get<MovementsContainer>();
+        tours = toursJson.get<std::map<std::string, Tour>>();
+    }
+    catch (const std::exception &e)
+    {
+        yCError(TOUR_COMPILER) << "Failed to parse the content:" << e.what();
+        return EXIT_FAILURE;
+    }
+
+    int errors = ValidateMovements(movements);
+    for (const auto &tour : tours)
+    {
+        errors += ValidateTour(tour.first, tour.second, movements);
+    }
+    if (errors > 0)
+    {
+        yCError(TOUR_COMPILER) << "Found" << errors << "errors. The snapshot was not written.";
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, float> durations;
+    for (auto &dance : movements.GetDances())
+    {
+        dance.second.UpdateDuration();
+        durations.insert({dance.first, dance.second.GetDuration()});
+    }
+
+    if (!TourSnapshot::Write(pathOutput, toursJson, movementsJson, durations))
+    {
+        return EXIT_FAILURE;
+    }
+    yCInfo(TOUR_COMPILER) << "Compiled" << tours.size() << "tours and" << durations.size() << "dances into" << pathOutput;
+    return EXIT_SUCCESS;
+}
@@ -12,4 +12,33 @@ service headSynchronizerRPC {
     bool busyFaceError();
     bool happyFace();
     bool busyFace();
+
+    /**
+     * Synthesizes in background the texts that are not in the speech clip store yet, so that they are played
+     * from the store when they are said. The speech has the precedence over them.
+     * @param texts the texts, usually all the speak actions of a tour in the current language
+     * @return false if the speech clip store is not used
+     */
+    bool prepareSpeech(1:list<string> texts);
+
+    /**
+     * @return true if no status of the audio player or of the microphone has been received for statusTimeout seconds,
+     *         In that case isHearing reports the last known state and the waits for the audio player give up
+     */
+    bool isStatusStale();
+
+    /**
+     * Queues a text to be spoken, like say. Its progress is published on the speechEvents:o port
+     * @param text the text to speak
+     * @return the id of the utterance, increasing with every text queued, or -1 if the speech queue is full
+     */
+    i64 sayUtterance(1:string text);
+
+    /**
+     * Waits until an utterance has been spoken, or dropped by a reset
+     * @param id the id returned by sayUtterance
+     * @param timeout the maximum time to wait in seconds, negative to wait forever
+     * @return true if the utterance is finished, false on timeout or if the id is unknown
+     */
+    bool waitForUtterance(1:i64 id, 2:double timeout);
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <tourClock.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Time.h>
+#include <string>
+
+YARP_LOG_COMPONENT(TOUR_CLOCK, "behavior_tour_robot.interfaces.TourClock", yarp::os::Log::TraceType)
+
+ScaledClock::ScaledClock(double scale, double epoch) : m_scale(scale),
+                                                       m_epoch(epoch)
+{
+}
+
+double ScaledClock::now()
+{
+    return m_epoch + (yarp::os::SystemClock::nowSystem() - m_epoch) * m_scale;
+}
+
+void ScaledClock::delay(double seconds)
+{
+    if (seconds > 0.0)
+    {
+        yarp::os::SystemClock::delaySystem(seconds / m_scale);
+    }
+}
+
+bool ScaledClock::isValid() const
+{
+    return true;
+}
+
+bool ConfigureClock(const yarp::os::Searchable &config)
+{
+    std::string clock = config.check("clock") ? config.find("clock").asString() : "system";
+    if (clock == "system")
+    {
+        return true;
+    }
+    else if (clock == "network")
+    {
+        std::string clockPort = config.check("clockPort") ? config.find("clockPort").asString() : "/clock";
+        yCInfo(TOUR_CLOCK) << "Following the network clock published on" << clockPort;
+        yarp::os::Time::useNetworkClock(clockPort);
+        return true;
+    }
+    else if (clock == "simulated")
+    {
+        double scale = config.check("clockScale") ? config.find("clockScale").asFloat64() : 100.0;
+        if (scale <= 0.0)
+        {
+            yCError(TOUR_CLOCK) << "The clockScale must be positive, got" << scale;
+            return false;
+        }
+        if (!config.check("clockEpoch"))
+        { // Anchored to 1970 the simulated time would be about scale times the current time, which overflows e.g. the ROS stamps
+            yCError(TOUR_CLOCK) << "The clockEpoch is required by the simulated clock, e.g. --clockEpoch $(date +%s)";
+            return false;
+        }
+        double epoch = config.find("clockEpoch").asFloat64();
+        if (epoch <= 0.0)
+        {
+            yCError(TOUR_CLOCK) << "The clockEpoch must be a positive system time in seconds since 1970, got" << epoch;
+            return false;
+        }
+        if (epoch > yarp::os::SystemClock::nowSystem())
+        {
+            yCError(TOUR_CLOCK) << "The clockEpoch must not be in the future, got" << epoch;
+            return false;
+        }
+        static ScaledClock scaledClock(scale, epoch); // Lives as long as the process, since yarp::os::Time does not own it
+        yCInfo(TOUR_CLOCK) << "Following a simulated clock" << scale << "times faster than the system one since" << epoch;
+        yCWarning(TOUR_CLOCK) << "The periods of the periodic threads are scaled too: they run" << scale << "times more often";
+        yarp::os::Time::useCustomClock(&scaledClock);
+        return true;
+    }
+    yCError(TOUR_CLOCK) << "Unknown clock" << clock << "expected system, network or simulated";
+    return false;
+}
@@ -0,0 +1,45 @@
+#ifndef BEHAVIOR_TOUR_ROBOT_TOUR_CLOCK_H
+#define BEHAVIOR_TOUR_ROBOT_TOUR_CLOCK_H
+
+#include <yarp/os/Clock.h>
+#include <yarp/os/Searchable.h>
+
+/**
+ * Clock running scale times faster than the system clock.
+ *
+ * Every yarp::os::Time::delay lasts 1/scale of its duration and yarp::os::Time::now advances scale seconds
+ * per real second, so that the delays of a tour (dances, delay_ signals, speech waits, error re-send loops)
+ * keep their proportions while a full scenario runs in a fraction of its duration.
+ *
+ * The simulated time is anchored to an epoch given in system time, not to the start of the process, so that
+ * the processes using the same scale and epoch agree on now(). The periods of the yarp::os::PeriodicThread
+ * are measured with this clock too, so they are scaled as well.
+ */
+class ScaledClock : public yarp::os::Clock
+{
+private:
+    const double m_scale;
+    const double m_epoch; // System time at which the simulated time is equal to the system one
+
+public:
+    ScaledClock(double scale, double epoch);
+
+    double now() override;
+    void delay(double seconds) override;
+    bool isValid() const override;
+};
+
+/**
+ * Selects the clock followed by yarp::os::Time in this process from the configuration:
+ *     clock       system (default), network or simulated
+ *     clockPort   the port publishing the network clock, e.g. the one of Gazebo (default /clock)
+ *     clockScale  how many times the simulated clock is faster than the system one (default 100)
+ *     clockEpoch  system time, in seconds since 1970, at which the simulated clock starts to run faster. Required by
+ *                 the simulated clock. The processes of a test must use the same scale and epoch to agree on the time
+ * Must be called before any thread using yarp::os::Time is started.
+ * @param config the configuration, usually the ResourceFinder of the module
+ * @return false if the options are not valid
+ */
+bool ConfigureClock(const yarp::os::Searchable &config);
+
+#endif // BEHAVIOR_TOUR_ROBOT_TOUR_CLOCK_H
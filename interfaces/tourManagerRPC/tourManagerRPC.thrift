@@ -4,4 +4,31 @@ service tourManagerRPC {
     bool sendToPoI();
     bool isAtPoI();
     string getCurrentPoIName();
+
+    /**
+     * Reloads the tour and the movements from their files without restarting the module.
+     * The commands being executed keep the previous content until they end.
+     * @return true if the new content has been loaded, false if it is not valid and the previous one is kept
+     */
+    bool reloadContent();
+
+    /**
+     * Starts the navigation to the current PoI in background, as sendToPoI does, and returns immediately.
+     * The queries of the service are not blocked while the navigation is running.
+     * @return the id of the navigation job, or -1 if it cannot be started
+     */
+    i32 sendToPoIAsync();
+
+    /**
+     * @param jobId the id returned by sendToPoIAsync
+     * @return the status of the job: "pending", "running", "succeeded", "failed", "cancelled" or "unknown"
+     */
+    string getJobStatus(1:i32 jobId);
+
+    /**
+     * Cancels a job. A running navigation is stopped.
+     * @param jobId the id returned by sendToPoIAsync
+     * @return false if the job does not exist or it has already ended
+     */
+    bool cancelJob(1:i32 jobId);
 }
@@ -7,6 +7,7 @@
   */
 
 #include "bt_waitGoalAvailability.h"
+#include <tourClock.h>
 
 int main(int argc, char *argv[])
 {
@@ -16,6 +17,11 @@ int main(int argc, char *argv[])
     // prepare and configure the resource finder
     yarp::os::ResourceFinder rf;
     rf.configure(argc, argv);
+    if (!ConfigureClock(rf))
+    {
+        yError() << "Invalid clock options";
+        return 1;
+    }
     std::string name = rf.check("name") ? rf.find("name").asString() : "waitGoalAvailability";
     waitGoalAvailability module(name);
 